@@ -0,0 +1,151 @@
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// Bump allocator for data that only lives until the end of a tick or a frame
+// (collision scratch, MCI command strings, ...). alloc() is a pointer bump in
+// one block, reset() drops everything at once; nothing is freed one by one.
+//
+// When the block runs out, alloc() falls back to the heap for the rest of the
+// period and reset() then regrows the block to the peak plus half, so the
+// first busy frames size it and the steady state never touches the heap.
+//
+// An Arena belongs to one thread at a time: GameWorld::scratch to whichever
+// thread runs the ticks (reset at the end of Simulation::tick), Arena::frame()
+// to the main thread (reset at the end of every drawn frame).
+class Arena {
+public:
+    explicit Arena(size_t capacity = 0) { regrow(capacity); }
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { freeSpills(); ::operator delete(block); }
+
+    // the main thread's per-frame arena
+    static Arena &frame() {
+        static Arena a(64 * 1024);
+        return a;
+    }
+
+    void *alloc(size_t n, size_t align = alignof(std::max_align_t)) {
+        size_t at = (top + align - 1) & ~(align - 1);
+        if (at + n <= cap) {
+            top = at + n;
+            peak = std::max(peak, top);
+            return block + at;
+        }
+
+        // out of room: heap until reset(), which makes the block big enough
+        Spill *s = (Spill *)::operator new(SPILL_HEADER + n);
+        s->next = spillList;
+        spillList = s;
+        spilled += n;
+        spillCount++;
+        peak = std::max(peak, top + spilled);
+        return (char *)s + SPILL_HEADER;
+    }
+
+    // only the newest allocation really goes back (a vector's old buffer
+    // right after it grew); anything else waits for reset()
+    void free(void *p, size_t n) {
+        char *c = (char *)p;
+        if (c >= block && c + n == block + top) top = c - block;
+    }
+
+    void reset() {
+        lastPeak = peak;
+        highWater = std::max(highWater, peak);
+        if (spillList) {
+            freeSpills();
+            regrow(peak + peak / 2);
+            grows++;
+        }
+        top = 0;
+        peak = 0;
+    }
+
+    // ---------- debug / profiler report ----------
+    size_t capacity() const { return cap; }
+    size_t used() const { return top + spilled; }
+    size_t lastPeakBytes() const { return lastPeak; }   // peak of the last period
+    size_t highWaterBytes() const { return highWater; } // peak of any period so far
+    long heapFallbacks() const { return spillCount; }   // allocations that missed the block
+    long regrows() const { return grows; }               // times reset() enlarged it
+
+    // the same in KB, rounded up (profiler counters)
+    int capacityKB() const { return kilobytes(cap); }
+    int lastPeakKB() const { return kilobytes(lastPeak); }
+    int highWaterKB() const { return kilobytes(highWater); }
+
+private:
+    struct Spill { Spill *next; };
+    static constexpr size_t SPILL_HEADER = (sizeof(Spill) + alignof(std::max_align_t) - 1)
+                                       & ~(alignof(std::max_align_t) - 1);
+
+    char *block = nullptr;
+    size_t cap = 0;
+    size_t top = 0;
+    size_t peak = 0;        // this period, spills included
+    size_t lastPeak = 0;
+    size_t highWater = 0;
+
+    Spill *spillList = nullptr;
+    size_t spilled = 0;
+    long spillCount = 0;
+    long grows = 0;
+
+    static int kilobytes(size_t bytes) { return (int)((bytes + 1023) / 1024); }
+
+    void regrow(size_t want) {
+        want = (want + 4095) & ~(size_t)4095;
+        if (want <= cap) return;
+        ::operator delete(block);
+        block = (char *)::operator new(want);
+        cap = want;
+    }
+
+    void freeSpills() {
+        while (spillList) {
+            Spill *next = spillList->next;
+            ::operator delete(spillList);
+            spillList = next;
+        }
+        spilled = 0;
+    }
+};
+
+// STL adapter: containers built with it take their memory from the arena
+// (null = the heap, like std::allocator). Only for containers that die
+// before the arena's next reset().
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    Arena *arena;
+
+    ArenaAllocator(Arena *a = nullptr) noexcept : arena(a) {}
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &o) noexcept : arena(o.arena) {}
+
+    T *allocate(size_t n) {
+        if (!arena) return std::allocator<T>().allocate(n);
+        return (T *)arena->alloc(n * sizeof(T), alignof(T));
+    }
+    void deallocate(T *p, size_t n) noexcept {
+        if (!arena) std::allocator<T>().deallocate(p, n);
+        else arena->free(p, n * sizeof(T));
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U> &o) const noexcept { return arena == o.arena; }
+    template <class U>
+    bool operator!=(const ArenaAllocator<U> &o) const noexcept { return arena != o.arena; }
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> ArenaString;
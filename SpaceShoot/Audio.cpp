@@ -1,38 +1,76 @@
-
+#ifdef _WIN32
 #include <windows.h>
 #include <mmsystem.h>
-#include <string>
 #pragma comment(lib, "winmm.lib")
+#endif
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
 
+// NOTE: expects Arena.cpp and AudioMixer.cpp to be included before this file.
+// Sound effects are decoded once in init() and played by the software mixer;
+// the calls below only queue a command for it. Voice limits and stealing are
+// the mixer's business, so hits overlap instead of restarting each other.
+// Background music is streamed by the mixer too and crossfades between the
+// home and game tracks. The mixer only streams WAV; when a track has no WAV
+// version, Windows falls back to playing the MP3 through MCI (elsewhere that
+// track is silent).
 class Audio {
 public:
     // --- change names here if you want ---
     static inline std::string DIR = "Audio/";
 
-    static inline std::string HOME_BGM   = "home.mp3";
-    static inline std::string GAME_BGM   = "game.mp3";
+    static inline std::string HOME_BGM   = "home.wav";
+    static inline std::string GAME_BGM   = "game.wav";
+
+    // MCI fallback (Windows only) when the WAV above is missing
+    static inline std::string HOME_BGM_MCI = "home.mp3";
+    static inline std::string GAME_BGM_MCI = "game.mp3";
 
     static inline std::string SFX_MOVE   = "move.wav";
     static inline std::string SFX_SHOOT  = "shoot.wav";
     static inline std::string SFX_ENEMY  = "enemyhit.wav";
     static inline std::string SFX_PLAYER = "playerhit.wav";
 
+    // --audio-wav <file>: mix into a WAV file instead of the sound device
+    static inline std::string WAV_OUT;
+
     static void init(const std::string& folder) {
         DIR = folder;
         if (!DIR.empty() && DIR.back() != '/' && DIR.back() != '\\') DIR += "/";
+
+        // loops outrank hits, so a burst of kills never cuts the engine or gun
+        AudioMixer &m = mixer();
+        sfxMove   = m.addSound(Sample::fromWav(DIR + SFX_MOVE),   1, 3);
+        sfxShoot  = m.addSound(Sample::fromWav(DIR + SFX_SHOOT),  1, 3);
+        sfxPlayer = m.addSound(Sample::fromWav(DIR + SFX_PLAYER), 2, 2);
+        sfxEnemy  = m.addSound(Sample::fromWav(DIR + SFX_ENEMY),  4, 1);
+        bgmHome = m.addTrack(DIR + HOME_BGM);
+        bgmGame = m.addTrack(DIR + GAME_BGM);
+        m.start(makeSink());
     }
 
     // --------- BGM ----------
-    static void playHomeBgm() { playBgm("bgm", DIR + HOME_BGM); }
-    static void playGameBgm() { playBgm("bgm", DIR + GAME_BGM); }
+    static void playHomeBgm() { playBgm(bgmHome, HOME_BGM_MCI); }
+    static void playGameBgm() { playBgm(bgmGame, GAME_BGM_MCI); }
 
-    static void stopBgm()  { send("stop bgm"); send("close bgm"); bgmOpen = false; bgmPaused = false; }
-    static void pauseBgm() { if (bgmOpen) { send("pause bgm"); bgmPaused = true; } }
-    static void resumeBgm(){ if (bgmOpen && bgmPaused) { send("resume bgm"); bgmPaused = false; } }
+    static void stopBgm() {
+        mixer().playMusic(-1);
+        stopMci();
+    }
+    static void pauseBgm() {
+        mixer().pauseMusic(true);
+        if (bgmOpen) { send("pause bgm"); bgmPaused = true; }
+    }
+    static void resumeBgm() {
+        mixer().pauseMusic(false);
+        if (bgmOpen && bgmPaused) { send("resume bgm"); bgmPaused = false; }
+    }
 
     // --------- LOOP SFX ----------
-    static void setMoveLoop(bool on)  { setLoop("move", DIR + SFX_MOVE, on, moveLoopOn); }
-    static void setShootLoop(bool on) { setLoop("shoot", DIR + SFX_SHOOT, on, shootLoopOn); }
+    static void setMoveLoop(bool on)  { setLoop(sfxMove, MOVE_LOOP, on, moveLoopOn); }
+    static void setShootLoop(bool on) { setLoop(sfxShoot, SHOOT_LOOP, on, shootLoopOn); }
 
     static void stopAllLoops() {
         if (moveLoopOn)  setMoveLoop(false);
@@ -40,65 +78,97 @@ public:
     }
 
     // --------- ONE SHOT ----------
-    static void enemyHit()  { oneShot("enemy",  DIR + SFX_ENEMY); }
-    static void playerHit() { oneShot("player", DIR + SFX_PLAYER); }
+    // n = how many happened this frame; they play as one louder hit
+    static void enemyHit(int n = 1)  { oneShot(sfxEnemy, n); }
+    static void playerHit(int n = 1) { oneShot(sfxPlayer, n); }
+
+    // for the profiler: voices in use and mixer CPU time since the last call
+    static AudioMixer::Stats takeStats() { return mixer().takeStats(); }
 
 private:
+    // mixer voice tags (one-shots need none)
+    enum { MOVE_LOOP = 1, SHOOT_LOOP };
+
+    static inline int sfxMove = -1, sfxShoot = -1, sfxEnemy = -1, sfxPlayer = -1;
+    static inline int bgmHome = -1, bgmGame = -1;
+
     static inline bool bgmOpen = false;
     static inline bool bgmPaused = false;
 
-    static inline bool moveOpen = false;
-    static inline bool shootOpen = false;
-
     static inline bool moveLoopOn = false;
     static inline bool shootLoopOn = false;
 
-    static void send(const std::string& cmd) {
-        mciSendStringA(cmd.c_str(), nullptr, 0, nullptr);
+    static AudioMixer &mixer() {
+        static AudioMixer m;   // stopped (thread joined) at exit
+        return m;
+    }
+
+    static std::unique_ptr<AudioSink> makeSink() {
+        if (!WAV_OUT.empty()) return std::unique_ptr<AudioSink>(new WavFileSink(WAV_OUT));
+#ifdef _WIN32
+        return std::unique_ptr<AudioSink>(new WaveOutSink());
+#else
+        return std::unique_ptr<AudioSink>(new NullSink());
+#endif
     }
 
-    static void openAlias(const std::string& alias, const std::string& path) {
+    static void send(const char *cmd) {
+#ifdef _WIN32
+        mciSendStringA(cmd, nullptr, 0, nullptr);
+#else
+        (void)cmd;
+#endif
+    }
+
+    // the command string lives in the frame arena, not on the heap
+    static void openAlias(const char *alias, const std::string& file) {
+        ArenaString cmd{ArenaAllocator<char>(&Arena::frame())};
         // mpegvideo handles mp3/wav in most Windows installs
-        std::string cmd = "open \"" + path + "\" type mpegvideo alias " + alias;
-        send(cmd);
+        cmd += "open \"";
+        cmd += DIR;
+        cmd += file;
+        cmd += "\" type mpegvideo alias ";
+        cmd += alias;
+        send(cmd.c_str());
     }
 
-    static void playBgm(const std::string& alias, const std::string& path) {
-        // close previous
-        send("stop " + alias);
-        send("close " + alias);
+    static void playBgm(int track, const std::string& mciFile) {
+        if (track >= 0) {
+            stopMci();
+            mixer().playMusic(track);
+            return;
+        }
 
-        openAlias(alias, path);
+        // no WAV: fade the mixer's music out and let MCI play the MP3
+        mixer().playMusic(-1);
+        stopMci();
+        openAlias("bgm", mciFile);
         bgmOpen = true;
         bgmPaused = false;
+        send("play bgm repeat");
+    }
 
-        send("play " + alias + " repeat");
+    static void stopMci() {
+        if (!bgmOpen) return;
+        send("stop bgm");
+        send("close bgm");
+        bgmOpen = false;
+        bgmPaused = false;
     }
 
-    static void setLoop(const std::string& alias, const std::string& path,
-                        bool wantOn, bool &stateFlag)
-    {
+    static void setLoop(int sound, int tag, bool wantOn, bool &stateFlag) {
         if (wantOn && !stateFlag) {
-            // start
-            send("stop " + alias);
-            send("close " + alias);
-            openAlias(alias, path);
-            send("play " + alias + " repeat");
+            mixer().play(sound, 1.0f, true, tag);
             stateFlag = true;
         }
         else if (!wantOn && stateFlag) {
-            // stop
-            send("stop " + alias);
-            send("close " + alias);
+            mixer().stopTag(tag);
             stateFlag = false;
         }
     }
 
-    static void oneShot(const std::string& alias, const std::string& path) {
-        // restart same sound quickly
-        send("stop " + alias);
-        send("close " + alias);
-        openAlias(alias, path);
-        send("play " + alias);
+    static void oneShot(int sound, int n) {
+        if (n <= 0) return;
+        mixer().play(sound, std::min(2.0f, std::sqrt((float)n)));
     }
 };
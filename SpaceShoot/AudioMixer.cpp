@@ -0,0 +1,783 @@
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// Software mixer behind Audio. Sounds are decoded into memory once, music is
+// streamed from disk by a music thread, the game thread only pushes small
+// commands into a lock-free queue, and a mixer thread turns the playing voices
+// and music into 16-bit stereo PCM for an AudioSink: waveOut on Windows,
+// nothing (or a WAV file, --audio-wav) anywhere else. Nothing on the game
+// thread touches the disk, takes a lock or allocates after init.
+
+// ---------- decoding ----------
+// Reads a RIFF / WAVE file with 8 or 16 bit PCM, mono or stereo, at any rate,
+// and hands it out at the mixer's format: 44.1 kHz, interleaved stereo, 16 bit
+// (resampled linearly). The file is read CHUNK bytes at a time into a buffer
+// inside the reader, so streaming a track of any length costs the same memory.
+class WavReader {
+public:
+    static const int RATE = 44100;
+    static const int CHUNK = 16384;   // whole frames for every supported layout
+
+    WavReader() {}
+    WavReader(const WavReader &) = delete;
+    WavReader &operator=(const WavReader &) = delete;
+    ~WavReader() { close(); }
+
+    // false if the file is missing or not a layout listed above
+    bool open(const std::string &path) {
+        close();
+        f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+
+        unsigned char h[12];
+        if (std::fread(h, 1, 12, f) != 12 || std::memcmp(h, "RIFF", 4) || std::memcmp(h + 8, "WAVE", 4)) {
+            close();
+            return false;
+        }
+
+        int format = 0;
+        bool haveData = false;
+        unsigned char c[8];
+        while (!haveData && std::fread(c, 1, 8, f) == 8) {
+            uint32_t size = le32(c + 4);
+            if (!std::memcmp(c, "fmt ", 4) && size >= 16) {
+                unsigned char fmt[40] = {};
+                size_t want = std::min<size_t>(size, sizeof(fmt));
+                if (std::fread(fmt, 1, want, f) != want) break;
+                format = le16(fmt);
+                channels = le16(fmt + 2);
+                rate = (int)le32(fmt + 4);
+                bits = le16(fmt + 14);
+                if (format == 0xFFFE && size >= 26) format = le16(fmt + 24);   // WAVE_FORMAT_EXTENSIBLE
+                std::fseek(f, (long)(size - want + (size & 1)), SEEK_CUR);
+            } else if (!std::memcmp(c, "data", 4)) {
+                dataStart = std::ftell(f);
+                dataBytes = size;
+                haveData = true;
+            } else {
+                std::fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+            }
+        }
+
+        if (!haveData || format != 1 || rate <= 0 ||
+            (channels != 1 && channels != 2) || (bits != 8 && bits != 16)) {
+            close();
+            return false;
+        }
+        bytesPerFrame = channels * bits / 8;
+        dataBytes -= dataBytes % bytesPerFrame;
+        step = (double)rate / RATE;
+        rewind();
+        return true;
+    }
+
+    void close() {
+        if (f) std::fclose(f);
+        f = nullptr;
+    }
+
+    bool isOpen() const { return f != nullptr; }
+
+    // length in output frames
+    int frames() const {
+        return f ? (int)((int64_t)(dataBytes / bytesPerFrame) * RATE / rate) : 0;
+    }
+
+    // Up to n output frames into out. At the end of the data it starts over
+    // with loop set, otherwise it stops and returns fewer.
+    int read(short *out, int n, bool loop) {
+        if (!f) return 0;
+        int done = 0;
+        while (done < n) {
+            if (!primed) {
+                if (!nextFrame(a, loop) || !nextFrame(b, loop)) break;
+                primed = true;
+            }
+            for (int ch = 0; ch < 2; ch++) {
+                float v = a[ch] + (b[ch] - a[ch]) * (float)t;
+                out[done * 2 + ch] = (short)std::max(-32768.0f, std::min(32767.0f, v));
+            }
+            done++;
+
+            t += step;
+            bool more = true;
+            while (t >= 1.0 && more) {
+                t -= 1.0;
+                a[0] = b[0]; a[1] = b[1];
+                more = nextFrame(b, loop);
+            }
+            if (!more) { close(); break; }
+        }
+        return done;
+    }
+
+private:
+    std::FILE *f = nullptr;
+    int channels = 0, bits = 0, rate = 0, bytesPerFrame = 0;
+    long dataStart = 0;
+    uint32_t dataBytes = 0, dataPos = 0;
+
+    unsigned char chunk[CHUNK];
+    int chunkLen = 0, chunkPos = 0;
+
+    // resampler: output sits t of the way from source frame a to b
+    double step = 1.0, t = 0.0;
+    float a[2] = {}, b[2] = {};
+    bool primed = false;
+
+    void rewind() {
+        std::fseek(f, dataStart, SEEK_SET);
+        dataPos = 0;
+        chunkLen = chunkPos = 0;
+    }
+
+    bool nextFrame(float out[2], bool loop) {
+        if (chunkPos == chunkLen) {
+            if (dataPos == dataBytes) {
+                if (!loop || dataBytes == 0) return false;
+                rewind();
+            }
+            size_t want = std::min<size_t>(CHUNK, dataBytes - dataPos);
+            chunkLen = (int)std::fread(chunk, 1, want, f);
+            chunkLen -= chunkLen % bytesPerFrame;
+            chunkPos = 0;
+            dataPos += (uint32_t)want;
+            if (chunkLen == 0) return false;   // truncated file
+        }
+        const unsigned char *p = &chunk[chunkPos];
+        for (int ch = 0; ch < 2; ch++) {
+            const unsigned char *s = p + (channels == 2 ? ch : 0) * (bits / 8);
+            out[ch] = bits == 8 ? (s[0] - 128) * 256.0f : (float)(short)le16(s);
+        }
+        chunkPos += bytesPerFrame;
+        return true;
+    }
+
+    static unsigned le16(const unsigned char *p) { return p[0] | (p[1] << 8); }
+    static uint32_t le32(const unsigned char *p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+};
+
+// ---------- samples ----------
+// A sound decoded completely into memory (short effects).
+struct Sample {
+    static const int RATE = WavReader::RATE;
+
+    std::vector<short> pcm;   // interleaved stereo
+
+    int frames() const { return (int)pcm.size() / 2; }
+
+    // See WavReader for the layouts. Anything else leaves the sample empty,
+    // and an empty sample just plays silence, like a missing file did with MCI.
+    static Sample fromWav(const std::string &path) {
+        Sample s;
+        std::unique_ptr<WavReader> r(new WavReader());   // CHUNK is too big for the stack
+        if (!r->open(path)) return s;
+
+        s.pcm.resize((size_t)r->frames() * 2);
+        s.pcm.resize((size_t)r->read(s.pcm.data(), r->frames(), false) * 2);
+        return s;
+    }
+};
+
+// ---------- sinks ----------
+// Where mixed blocks go. write() is called from the mixer thread only.
+class AudioSink {
+public:
+    virtual ~AudioSink() {}
+
+    // false if the output could not be opened (the mixer then falls back to
+    // a NullSink so the game still runs)
+    virtual bool open() = 0;
+    virtual void write(const short *pcm, int frames) = 0;
+    virtual void close() {}
+
+    // true if write() waits for the device, so it sets the pace; otherwise
+    // the mixer sleeps one block's worth of wall time per block
+    virtual bool paced() const { return false; }
+};
+
+// no sound device (Linux builds, or waveOut would not open)
+class NullSink : public AudioSink {
+public:
+    bool open() override { return true; }
+    void write(const short *, int) override {}
+};
+
+// everything the mixer produces, in real time, to a 16-bit stereo WAV file
+class WavFileSink : public AudioSink {
+public:
+    explicit WavFileSink(const std::string &p) : path(p) {}
+    ~WavFileSink() override { close(); }
+
+    bool open() override {
+        f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        writeHeader(0);
+        return true;
+    }
+
+    void write(const short *pcm, int frames) override {
+        if (!f) return;
+        std::fwrite(pcm, sizeof(short) * 2, (size_t)frames, f);
+        bytes += (uint32_t)frames * 4;
+    }
+
+    void close() override {
+        if (!f) return;
+        std::fseek(f, 0, SEEK_SET);
+        writeHeader(bytes);
+        std::fclose(f);
+        f = nullptr;
+    }
+
+private:
+    std::string path;
+    std::FILE *f = nullptr;
+    uint32_t bytes = 0;
+
+    void writeHeader(uint32_t dataBytes) {
+        unsigned char h[44];
+        std::memcpy(h, "RIFF", 4);   put32(h + 4, 36 + dataBytes);
+        std::memcpy(h + 8, "WAVEfmt ", 8);
+        put32(h + 16, 16);
+        put16(h + 20, 1);            // PCM
+        put16(h + 22, 2);            // stereo
+        put32(h + 24, Sample::RATE);
+        put32(h + 28, Sample::RATE * 4);
+        put16(h + 32, 4);            // bytes per frame
+        put16(h + 34, 16);
+        std::memcpy(h + 36, "data", 4);
+        put32(h + 40, dataBytes);
+        std::fwrite(h, 1, sizeof(h), f);
+    }
+
+    static void put16(unsigned char *p, unsigned v) { p[0] = v & 255; p[1] = (v >> 8) & 255; }
+    static void put32(unsigned char *p, uint32_t v) { put16(p, v & 0xFFFF); put16(p + 2, v >> 16); }
+};
+
+#ifdef _WIN32
+// waveOut with a few blocks queued ahead of the device (about 46 ms)
+class WaveOutSink : public AudioSink {
+public:
+    ~WaveOutSink() override { close(); }
+
+    bool open() override {
+        WAVEFORMATEX fmt = {};
+        fmt.wFormatTag = WAVE_FORMAT_PCM;
+        fmt.nChannels = 2;
+        fmt.nSamplesPerSec = Sample::RATE;
+        fmt.wBitsPerSample = 16;
+        fmt.nBlockAlign = 4;
+        fmt.nAvgBytesPerSec = Sample::RATE * 4;
+        if (waveOutOpen(&dev, WAVE_MAPPER, &fmt, 0, 0, CALLBACK_NULL) != MMSYSERR_NOERROR) {
+            dev = nullptr;
+            return false;
+        }
+        return true;
+    }
+
+    void write(const short *pcm, int frames) override {
+        if (!dev) return;
+        WAVEHDR &h = hdr[next];
+        Block &b = blocks[next];
+
+        // wait for the device to hand this block back
+        // (the driver sets WHDR_DONE behind our back, hence the volatile read)
+        while ((h.dwFlags & WHDR_PREPARED) && !(((volatile DWORD &)h.dwFlags) & WHDR_DONE)) Sleep(1);
+        if (h.dwFlags & WHDR_PREPARED) waveOutUnprepareHeader(dev, &h, sizeof(h));
+
+        frames = std::min(frames, MAX_FRAMES);
+        std::memcpy(b.pcm, pcm, (size_t)frames * 4);
+        h = WAVEHDR();
+        h.lpData = (LPSTR)b.pcm;
+        h.dwBufferLength = (DWORD)frames * 4;
+        waveOutPrepareHeader(dev, &h, sizeof(h));
+        waveOutWrite(dev, &h, sizeof(h));
+
+        next = (next + 1) % BLOCKS;
+    }
+
+    void close() override {
+        if (!dev) return;
+        waveOutReset(dev);
+        for (WAVEHDR &h : hdr) {
+            if (h.dwFlags & WHDR_PREPARED) waveOutUnprepareHeader(dev, &h, sizeof(h));
+        }
+        waveOutClose(dev);
+        dev = nullptr;
+    }
+
+    bool paced() const override { return true; }
+
+private:
+    static const int BLOCKS = 4;
+    static const int MAX_FRAMES = 1024;
+
+    struct Block { short pcm[MAX_FRAMES * 2]; };
+
+    HWAVEOUT dev = nullptr;
+    WAVEHDR hdr[BLOCKS] = {};
+    Block blocks[BLOCKS];
+    int next = 0;
+};
+#endif
+
+// ---------- mixer ----------
+// A fixed pool of voices. Each sound has a polyphony limit and a priority
+// (see addSound), and identical triggers within one block merge into a single
+// louder voice, so the mixing cost is capped at MAX_VOICES however fast the
+// game fires sounds.
+//
+// Music plays on two decks so one track can fade into the next. The music
+// thread streams each deck's track from disk into that deck's fixed ring,
+// keeping it full ahead of the mixer; the mixer only ever reads the ring.
+class AudioMixer {
+public:
+    static const int MAX_SOUNDS = 16;
+    static const int MAX_VOICES = 16;
+    static const int MAX_TRACKS = 4;
+    static const int BLOCK = 512;         // frames per mix, about 11.6 ms
+
+    AudioMixer() {}
+    AudioMixer(const AudioMixer &) = delete;
+    AudioMixer &operator=(const AudioMixer &) = delete;
+    ~AudioMixer() { stop(); }
+
+    // Before start() only: returns the sound's id, or -1 when the table is full.
+    // At most maxVoices copies of the sound play at once (a new one replaces
+    // the oldest); when the pool is full, a sound can only take the voice of
+    // one with the same or a lower priority.
+    int addSound(Sample s, int maxVoices = MAX_VOICES, int priority = 0) {
+        if (soundCount == MAX_SOUNDS) return -1;
+        Sound &d = sounds[soundCount];
+        d.sample = std::move(s);
+        d.maxVoices = std::max(1, maxVoices);
+        d.priority = priority;
+        return soundCount++;
+    }
+
+    // Before start() only: a music file for playMusic(). Returns its id, or -1
+    // when the table is full or the file does not open as a WAV.
+    int addTrack(const std::string &path) {
+        if (trackCount == MAX_TRACKS) return -1;
+        std::unique_ptr<WavReader> probe(new WavReader());
+        if (!probe->open(path)) return -1;
+        tracks[trackCount] = path;
+        return trackCount++;
+    }
+
+    // what the mixer thread did since the last takeStats() (game thread)
+    struct Stats {
+        int voices = 0;          // playing after the last block
+        int peakVoices = 0;
+        float mixMs = 0.0f;      // CPU time in render()
+        int coalesced = 0;       // triggers merged into a voice started in the same block
+        int stolen = 0;
+        int dropped = 0;         // nothing it was allowed to take
+        int musicUnderruns = 0;  // blocks the music thread had not filled in time
+    };
+
+    Stats takeStats() {
+        Stats st;
+        st.voices = playing.load(std::memory_order_relaxed);
+        st.peakVoices = peak.exchange(0, std::memory_order_relaxed);
+        st.mixMs = mixNs.exchange(0, std::memory_order_relaxed) / 1e6f;
+        st.coalesced = coalesced.exchange(0, std::memory_order_relaxed);
+        st.stolen = stolen.exchange(0, std::memory_order_relaxed);
+        st.dropped = dropped.exchange(0, std::memory_order_relaxed);
+        st.musicUnderruns = underruns.exchange(0, std::memory_order_relaxed);
+        return st;
+    }
+
+    void start(std::unique_ptr<AudioSink> out) {
+        stop();
+        sink = std::move(out);
+        if (!sink || !sink->open()) {
+            sink.reset(new NullSink());
+            sink->open();
+        }
+        quit = false;
+        thread = std::thread([this] { loop(); });
+        if (trackCount > 0) musicThread = std::thread([this] { musicLoop(); });
+    }
+
+    void stop() {
+        if (!thread.joinable()) return;
+        quit = true;
+        thread.join();
+        if (musicThread.joinable()) musicThread.join();
+        sink->close();
+    }
+
+    // ---------- game thread: never blocks, never allocates ----------
+    // A full queue drops the command (a sound too many, never a stall).
+
+    // one-shot, or a loop that keeps going until stopTag(tag)
+    void play(int sound, float gain = 1.0f, bool loop = false, int tag = 0) {
+        Command c;
+        c.type = Command::PLAY;
+        c.sound = sound;
+        c.gain = gain;
+        c.loop = loop;
+        c.tag = tag;
+        commands.push(c);
+    }
+
+    // stops every voice started with this tag
+    void stopTag(int tag) {
+        Command c;
+        c.type = Command::STOP;
+        c.tag = tag;
+        commands.push(c);
+    }
+
+    // Crossfades from the music playing now to track over fadeSec; -1 fades
+    // out. Asking for the track that is already playing does nothing.
+    void playMusic(int track, float fadeSec = 1.5f) {
+        Command c;
+        c.type = Command::MUSIC;
+        c.sound = track;
+        c.gain = fadeSec;
+        commands.push(c);
+    }
+
+    // holds the music where it is (voices keep playing)
+    void pauseMusic(bool paused) {
+        Command c;
+        c.type = paused ? Command::MUSIC_PAUSE : Command::MUSIC_RESUME;
+        commands.push(c);
+    }
+
+    // ---------- mixer thread ----------
+    // Applies the queued commands and mixes frames (<= BLOCK) of output. The
+    // mixer thread calls this; Bench calls it directly, without start().
+    void render(short *out, int frames) {
+        blocks++;
+        Command c;
+        while (commands.pop(c)) apply(c);
+
+        int acc[BLOCK * 2];
+        std::fill(acc, acc + frames * 2, 0);
+
+        if (!musicPaused) {
+            for (Deck &d : decks) mixDeck(d, acc, frames);
+        }
+
+        for (Voice &v : voices) {
+            if (v.sound < 0) continue;
+            const Sample &s = sounds[v.sound].sample;
+            const int len = s.frames();
+            if (len == 0) { v.sound = -1; continue; }
+
+            const int g = (int)(v.gain * 256.0f);   // 8.8 fixed point
+            int i = 0;
+            while (i < frames) {
+                int n = std::min(frames - i, len - v.pos);
+                const short *src = &s.pcm[(size_t)v.pos * 2];
+                for (int k = 0; k < n * 2; k++) acc[i * 2 + k] += (src[k] * g) >> 8;
+                i += n;
+                v.pos += n;
+                if (v.pos == len) {
+                    if (!v.loop) { v.sound = -1; break; }
+                    v.pos = 0;
+                }
+            }
+        }
+
+        for (int k = 0; k < frames * 2; k++) {
+            out[k] = (short)std::max(-32768, std::min(32767, acc[k]));
+        }
+
+        int n = activeVoices();
+        playing.store(n, std::memory_order_relaxed);
+        if (n > peak.load(std::memory_order_relaxed)) peak.store(n, std::memory_order_relaxed);
+    }
+
+    int activeVoices() const {
+        int n = 0;
+        for (const Voice &v : voices) if (v.sound >= 0) n++;
+        return n;
+    }
+
+private:
+    struct Command {
+        enum Type { PLAY, STOP, MUSIC, MUSIC_PAUSE, MUSIC_RESUME } type = PLAY;
+        int sound = -1;         // track for MUSIC
+        float gain = 1.0f;      // fade seconds for MUSIC
+        bool loop = false;
+        int tag = 0;
+    };
+
+    // single producer (game thread) / single consumer (mixer thread)
+    class CommandQueue {
+    public:
+        bool push(const Command &c) {
+            unsigned t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == CAP) return false;
+            ring[t % CAP] = c;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+        bool pop(Command &c) {
+            unsigned h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) return false;
+            c = ring[h % CAP];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+    private:
+        static const unsigned CAP = 256;
+        Command ring[CAP];
+        std::atomic<unsigned> head{0}, tail{0};
+    };
+
+    struct Sound {
+        Sample sample;
+        int maxVoices = MAX_VOICES;
+        int priority = 0;
+    };
+
+    struct Voice {
+        int sound = -1;     // -1 = free
+        int pos = 0;        // next frame
+        float gain = 1.0f;
+        bool loop = false;
+        int tag = 0;
+        long started = 0;   // apply() count, for stealing the oldest
+        long block = 0;     // render() it started in
+    };
+
+    // a burst of the same sound in one block plays as one voice, this loud at most
+    static constexpr float MAX_COALESCED_GAIN = 2.0f;
+
+    Sound sounds[MAX_SOUNDS];
+    int soundCount = 0;
+
+    Voice voices[MAX_VOICES];
+    long commandsApplied = 0;
+    long blocks = 0;
+    CommandQueue commands;
+
+    std::atomic<int> playing{0}, peak{0};
+    std::atomic<long long> mixNs{0};
+    std::atomic<int> coalesced{0}, stolen{0}, dropped{0};
+
+    // ---------- music ----------
+    static const int MUSIC_RING = 32768;   // frames per deck, ~0.74 s ahead of the mixer
+    static const int MUSIC_FILL = 4096;    // frames per read on the music thread
+
+    struct Deck {
+        // mixer thread
+        int track = -1;                    // -1 = silent
+        float gain = 0.0f, target = 0.0f, step = 0.0f;
+
+        // mixer -> music thread: stream wantTrack, for request wantGen
+        std::atomic<int> wantTrack{-1};
+        std::atomic<unsigned> wantGen{0};
+
+        // music thread -> mixer: the ring holds wantGen's track from frame 0
+        std::atomic<unsigned> readyGen{0};
+        std::atomic<unsigned> written{0}, read{0};
+        short ring[MUSIC_RING * 2];
+
+        WavReader reader;                  // music thread only
+    };
+
+    std::string tracks[MAX_TRACKS];
+    int trackCount = 0;
+
+    Deck decks[2];
+    int currentDeck = 0;
+    bool musicPaused = false;
+    std::atomic<int> underruns{0};
+
+    std::unique_ptr<AudioSink> sink;
+    std::thread thread, musicThread;
+    std::atomic<bool> quit{false};
+
+    void applyMusic(const Command &c) {
+        if (c.type != Command::MUSIC) {
+            musicPaused = c.type == Command::MUSIC_PAUSE;
+            return;
+        }
+        if (c.sound >= trackCount) return;
+
+        Deck &cur = decks[currentDeck];
+        if (c.sound >= 0 && c.sound == cur.track && cur.target > 0.0f) return;
+
+        const float step = c.gain > 0.0f ? 1.0f / (c.gain * Sample::RATE) : 1.0f;
+        cur.target = 0.0f;
+        cur.step = step;
+        if (c.sound < 0) return;
+
+        // the other deck (cutting it short if it is still fading out)
+        currentDeck = 1 - currentDeck;
+        Deck &d = decks[currentDeck];
+        d.track = c.sound;
+        d.gain = 0.0f;
+        d.target = 1.0f;
+        d.step = step;
+        request(d, c.sound);
+    }
+
+    void request(Deck &d, int track) {
+        d.wantTrack.store(track, std::memory_order_relaxed);
+        d.wantGen.fetch_add(1, std::memory_order_release);
+    }
+
+    void mixDeck(Deck &d, int *acc, int frames) {
+        if (d.track < 0) return;
+        if (d.readyGen.load(std::memory_order_acquire) != d.wantGen.load(std::memory_order_relaxed)) return;
+
+        const unsigned r = d.read.load(std::memory_order_relaxed);
+        const unsigned w = d.written.load(std::memory_order_acquire);
+        const int n = (int)std::min<unsigned>((unsigned)frames, w - r);
+        if (n < frames) underruns.fetch_add(1, std::memory_order_relaxed);
+
+        for (int i = 0; i < n; i++) {
+            if (d.gain < d.target) d.gain = std::min(d.target, d.gain + d.step);
+            else if (d.gain > d.target) d.gain = std::max(d.target, d.gain - d.step);
+
+            const short *s = &d.ring[((r + i) % MUSIC_RING) * 2];
+            acc[i * 2]     += (int)(s[0] * d.gain);
+            acc[i * 2 + 1] += (int)(s[1] * d.gain);
+        }
+        d.read.store(r + n, std::memory_order_release);
+
+        // faded out: let the music thread close the file
+        if (d.gain <= 0.0f && d.target <= 0.0f) {
+            d.track = -1;
+            request(d, -1);
+        }
+    }
+
+    // Opens / closes tracks as the mixer asks and keeps every ring topped up.
+    // Polls: the rings hold far more than one sleep's worth of music.
+    void musicLoop() {
+        while (!quit) {
+            for (Deck &d : decks) {
+                const unsigned gen = d.wantGen.load(std::memory_order_acquire);
+                if (gen != d.readyGen.load(std::memory_order_relaxed)) {
+                    // the mixer does not touch this deck until readyGen == gen
+                    d.reader.close();
+                    d.written.store(0, std::memory_order_relaxed);
+                    d.read.store(0, std::memory_order_relaxed);
+                    const int t = d.wantTrack.load(std::memory_order_relaxed);
+                    if (t >= 0) d.reader.open(tracks[t]);
+                    fillDeck(d);
+                    d.readyGen.store(gen, std::memory_order_release);
+                } else {
+                    fillDeck(d);
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void fillDeck(Deck &d) {
+        if (!d.reader.isOpen()) return;
+        unsigned w = d.written.load(std::memory_order_relaxed);
+        int space = MUSIC_RING - (int)(w - d.read.load(std::memory_order_acquire));
+        while (space > 0) {
+            const int pos = (int)(w % MUSIC_RING);
+            int n = std::min(std::min(space, MUSIC_FILL), MUSIC_RING - pos);
+            n = d.reader.read(&d.ring[pos * 2], n, true);
+            if (n == 0) break;
+            w += n;
+            space -= n;
+            d.written.store(w, std::memory_order_release);
+        }
+    }
+
+    void apply(const Command &c) {
+        commandsApplied++;
+        if (c.type >= Command::MUSIC) {
+            applyMusic(c);
+            return;
+        }
+        if (c.type == Command::STOP) {
+            for (Voice &v : voices) if (v.sound >= 0 && v.tag == c.tag) v.sound = -1;
+            return;
+        }
+        if (c.sound < 0 || c.sound >= soundCount) return;
+        const Sound &snd = sounds[c.sound];
+
+        // Same sound already started in this block: make that one louder
+        // instead (summing energy, so n hits come out sqrt(n) times as loud).
+        // Also the same-sound voice count and the oldest of them.
+        int same = 0;
+        Voice *oldestSame = nullptr;
+        for (Voice &v : voices) {
+            if (v.sound != c.sound || v.loop != c.loop) continue;
+            if (v.block == blocks && v.pos == 0 && !c.loop) {
+                v.gain = std::min(MAX_COALESCED_GAIN, std::sqrt(v.gain * v.gain + c.gain * c.gain));
+                coalesced.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            same++;
+            if (!oldestSame || v.started < oldestSame->started) oldestSame = &v;
+        }
+
+        Voice *pick = nullptr;
+        if (same >= snd.maxVoices) {
+            pick = oldestSame;   // over its own limit: replace its oldest copy
+        } else {
+            // a free voice, else the lowest priority (then oldest) one it outranks
+            for (Voice &v : voices) {
+                if (v.sound < 0) { pick = &v; break; }
+                int p = sounds[v.sound].priority;
+                if (p > snd.priority) continue;
+                if (!pick || p < sounds[pick->sound].priority ||
+                    (p == sounds[pick->sound].priority && v.started < pick->started)) pick = &v;
+            }
+        }
+        if (!pick) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (pick->sound >= 0) stolen.fetch_add(1, std::memory_order_relaxed);
+
+        pick->sound = c.sound;
+        pick->pos = 0;
+        pick->gain = c.gain;
+        pick->loop = c.loop;
+        pick->tag = c.tag;
+        pick->started = commandsApplied;
+        pick->block = blocks;
+    }
+
+    void loop() {
+        using clock = std::chrono::steady_clock;
+        const auto blockTime = std::chrono::microseconds((long long)BLOCK * 1000000 / Sample::RATE);
+        auto next = clock::now();
+
+        short pcm[BLOCK * 2];
+        while (!quit) {
+            auto t0 = clock::now();
+            render(pcm, BLOCK);
+            mixNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0).count(),
+                            std::memory_order_relaxed);
+            sink->write(pcm, BLOCK);
+            if (!sink->paced()) {
+                next += blockTime;
+                std::this_thread::sleep_until(next);
+            }
+        }
+    }
+};
@@ -1,9 +1,18 @@
 #include <GL/glut.h>
 #include <vector>
-#include <cstdlib>
-#include <ctime>
 #include <cmath>
-
+#include <memory>
+#include <algorithm>
+
+// Infinite star / planet backdrop, cut into CHUNK x CHUNK squares. A chunk's
+// content is a pure function of (run seed, chunk coordinates), so it can be
+// generated whenever the camera first gets near it, thrown away when it has
+// not been seen for a while (LRU over a fixed number of slots) and come back
+// identical later. Only the chunks around the camera are ever touched, so the
+// cost follows the screen area, not how much sky there is.
+//
+// The simulation never looks at the chunks (nothing collides with stars), so
+// only draw() generates them; update() just advances time and the meteors.
 class Background {
 public:
     struct Star {
@@ -22,104 +31,102 @@ public:
         float moonDist;
         float moonRadius;
         float moonSpeed;
-        float moonPhase;
+        float moonPhase;    // at tick 0, draw() adds moonSpeed per tick
     };
 
+    // what a meteor has on top of Movers' motion components
     struct Meteor {
-        bool active = false;
-        float x, y;
-        float vx, vy;
         float size;
-        float life; // countdown
     };
 
-    std::vector<Star> stars;
-    std::vector<Planet> planets;
-    Meteor meteor;
+    static constexpr float CHUNK = 4.0f;   // world units per chunk side
+
+    // star density, as stars per 16 x 16 area (what the old wrapping field
+    // held); --stars N
+    int starCount = 160;
+
+    // at most one crossing at a time (life = frames left)
+    Movers<Meteor> meteors{1};
 
     float t = 0.0f;
+    long ticks = 0;
     int meteorCooldown = 180; // frames until next meteor (randomized)
 
+    // own stream, so meteor rolls never shift enemy spawns
+    Rng rng;
+
     // ---------- init ----------
-    void init(int seed = 0) {
-        if (seed == 0) seed = (int)std::time(nullptr);
-        std::srand(seed);
-
-        stars.clear();
-        planets.clear();
-        meteor.active = false;
-        meteorCooldown = 120 + (std::rand() % 240);
-
-        // create a starfield around origin
-        for (int i = 0; i < 160; i++) stars.push_back(makeStar(0.0f, 0.0f));
-        for (int i = 0; i < 6; i++)   planets.push_back(makePlanetFar(0.0f, 0.0f));
+    void init(uint64_t seed) {
+        rng.seed(seed, Rng::BACKGROUND);
+        runSeed = seed;
+
+        t = 0.0f;
+        ticks = 0;
+        meteors.clear();
+        meteorCooldown = 120 + rng.below(240);
+
+        // copies (the render snapshots) share the cache, only draw() uses it
+        chunks = std::make_shared<ChunkCache>();
     }
 
     // ---------- update ----------
     void update(const Player &player, const Movement &move) {
         t += 0.016f;
-
-        // Wrap stars/planets around player so it feels infinite
-        wrapStars(player);
-        wrapPlanets(player);
-
-        // Occasionally spawn new planets (slow)
-        if ((std::rand() % 240) == 0 && (int)planets.size() < 10) {
-            Planet p = makePlanetFar(player.x, player.y);
-            planets.push_back(p);
-        }
+        ticks++;
 
         // Meteor logic
-        if (!meteor.active) {
+        if (meteors.empty()) {
             meteorCooldown--;
             if (meteorCooldown <= 0) {
                 spawnMeteor(player);
-                meteorCooldown = 200 + (std::rand() % 260);
+                meteorCooldown = 200 + rng.below(260);
             }
         } else {
-            meteor.x += meteor.vx;
-            meteor.y += meteor.vy;
-            meteor.life -= 1.0f;
-
-            if (meteor.life <= 0.0f) meteor.active = false;
+            meteors.integrate(1.0f);
+            meteors.sweep();
         }
+    }
 
-        // Update moons
-        for (auto &p : planets) p.moonPhase += p.moonSpeed;
+    // Generates / touches every chunk the camera can see (no GL, Bench times
+    // it on its own) and returns how many that is.
+    int prepare(const ViewRect &view) const {
+        if (!chunks) return 0;
+        int n = 0;
+        forVisible(view, [&](const Chunk &) { n++; });
+        return n;
     }
 
+    // what draw() did, for the profiler's culling counters
+    struct DrawStats {
+        int chunks = 0;
+        int planets = 0;          // drawn
+        int planetsCulled = 0;    // in a visible chunk but off screen
+    };
+
     // ---------- draw ----------
-    void draw(const Player &player) const {
-        // Draw stars (small circles)
-        for (const auto &s : stars) {
-            glColor3f(s.r, s.g, s.b);
-            glPushMatrix();
-            glTranslatef(s.x, s.y, 0.0f);
-            Shapes::Circle(s.size, 10);
-            glPopMatrix();
-        }
+    DrawStats draw(const Player &player, RenderBatch &batch, const ViewRect &view) const {
+        DrawStats st;
+        batch.reset();
+        if (!chunks) return st;
+
+        // Draw stars (small circles built with their chunk, one draw call each)
+        forVisible(view, [&](const Chunk &c) {
+            batch.drawTriangles(chunks->starVerts(c), c.starVertCount);
+            st.chunks++;
+        });
 
         // Draw planets (big circles + moons)
-        for (const auto &p : planets) {
-            glColor3f(p.r, p.g, p.b);
-            glPushMatrix();
-            glTranslatef(p.x, p.y, 0.0f);
-            Shapes::Circle(p.radius, 60);
-            glPopMatrix();
-
-            // moons
-            for (int m = 0; m < p.moons; m++) {
-                float ph = p.moonPhase + m * 3.14159f * 0.7f;
-                float mx = p.x + std::cos(ph) * p.moonDist;
-                float my = p.y + std::sin(ph) * p.moonDist;
-
-                glColor3f(0.95f, 0.95f, 0.95f); // moon color
-                glPushMatrix();
-                glTranslatef(mx, my, 0.0f);
-                Shapes::Circle(p.moonRadius, 30);
-                glPopMatrix();
+        forVisible(view, [&](const Chunk &c) {
+            if (!c.hasPlanet) return;
+            const Planet &p = c.planet;
+            if (view.visible(p.x, p.y, std::max(p.radius, p.moonDist + p.moonRadius))) {
+                drawPlanet(batch, p);
+                st.planets++;
+            } else {
+                st.planetsCulled++;
             }
-        }
+        });
+        batch.flush();
 
         // Draw a “sun” (fixed far away, warm color)
         // Draw a “guiding star” near the player (shiny white star)
@@ -131,128 +138,259 @@ glPopMatrix();
 
 
         // Draw meteor (passes sometimes)
-        if (meteor.active) {
-            drawMeteor();
+        if (!meteors.empty()) {
+            for (const auto &m : meteors) drawMeteor(batch, m);
+            batch.flush();
         }
+        return st;
     }
 
 private:
-    // --------- helpers ----------
-    static float rf(float a, float b) {
-        return a + (b - a) * (float(std::rand()) / float(RAND_MAX));
-    }
+    struct Chunk {
+        int cx = 0, cy = 0;
+        bool used = false;
+        long lastSeen = 0;       // ChunkCache::frame it was last visible in
+        int level = 0;           // Shapes LOD level the stars were built for
+        int starVertCount = 0;
+        bool hasPlanet = false;
+        Planet planet;
+    };
 
-    Star makeStar(float cx, float cy) {
-        Star s;
-        float range = rf(3.0f, 7.0f);
-        s.x = cx + rf(-range, range);
-        s.y = cy + rf(-range, range);
-
-        // subtle star colors
-        float tint = rf(0.8f, 1.0f);
-        s.r = tint;
-        s.g = tint;
-        s.b = rf(0.85f, 1.0f);
-
-        s.size = rf(0.006f, 0.02f);
-        s.parallax = rf(0.25f, 1.0f);
-        return s;
-    }
+    // Fixed slots, so nothing allocates once a density is set up. Lookups are
+    // a scan of MAX_CHUNKS keys: a few hundred compares per frame, and the
+    // whole visible window always fits.
+    class ChunkCache {
+    public:
+        static const int MAX_CHUNKS = 64;
+        static const int STAR_SEGMENTS = 10;
+
+        long frame = 0;
+
+        const Chunk &get(int cx, int cy, uint64_t seed, int starsPerChunk, int level) {
+            if (starsPerChunk != perChunk) reset(starsPerChunk);
+
+            int victim = 0;
+            for (int i = 0; i < MAX_CHUNKS; i++) {
+                Chunk &c = slots[i];
+                if (c.used && c.cx == cx && c.cy == cy) {
+                    // zoomed across a LOD level: same stars, new segment counts
+                    if (c.level != level) generate(c, i, cx, cy, seed, level);
+                    c.lastSeen = frame;
+                    return c;
+                }
+                // free slots first, then the least recently seen
+                if (!slots[victim].used) continue;
+                if (!c.used || c.lastSeen < slots[victim].lastSeen) victim = i;
+            }
 
-    Planet makePlanetFar(float px, float py) {
-        Planet p;
+            Chunk &c = slots[victim];
+            generate(c, victim, cx, cy, seed, level);
+            c.lastSeen = frame;
+            return c;
+        }
 
-        // spawn far around player, but not on top
-        float range = rf(2.5f, 6.5f);
-        float angle = rf(0.0f, 2.0f * 3.1415926f);
+        const RenderBatch::Vertex *starVerts(const Chunk &c) const {
+            if (verts.empty()) return nullptr;   // --stars 0
+            return &verts[(size_t)(&c - &slots[0]) * vertsPerChunk()];
+        }
 
-        p.x = px + std::cos(angle) * range;
-        p.y = py + std::sin(angle) * range;
+    private:
+        Chunk slots[MAX_CHUNKS];
+        std::vector<RenderBatch::Vertex> verts;   // [slot][star][<= 3 * STAR_SEGMENTS]
+        int perChunk = -1;
 
-        p.radius = rf(0.12f, 0.45f);
-        p.r = rf(0.2f, 1.0f);
-        p.g = rf(0.2f, 1.0f);
-        p.b = rf(0.2f, 1.0f);
+        int vertsPerChunk() const { return perChunk * 3 * STAR_SEGMENTS; }
 
-        p.parallax = rf(0.08f, 0.20f);
+        void reset(int starsPerChunk) {
+            perChunk = starsPerChunk;
+            verts.assign((size_t)MAX_CHUNKS * vertsPerChunk(), RenderBatch::Vertex());
+            for (Chunk &c : slots) c.used = false;
+        }
 
-        p.moons = std::rand() % 3; // 0..2
-        p.moonDist = p.radius + rf(0.10f, 0.25f);
-        p.moonRadius = rf(0.03f, 0.07f);
-        p.moonSpeed = rf(0.02f, 0.05f);
-        p.moonPhase = rf(0.0f, 6.28f);
+        static uint64_t chunkSeed(uint64_t seed, int cx, int cy) {
+            // splitmix64 over the seed and both coordinates
+            uint64_t h = seed ^ ((uint64_t)(uint32_t)cx * 0x9E3779B97F4A7C15ULL)
+                              ^ ((uint64_t)(uint32_t)cy * 0xC2B2AE3D27D4EB4FULL);
+            h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+            return h ^ (h >> 31);
+        }
 
-        return p;
-    }
+        void generate(Chunk &c, int slot, int cx, int cy, uint64_t seed, int level) {
+            Rng rng(chunkSeed(seed, cx, cy), Rng::BACKGROUND);
+            const float x0 = cx * CHUNK, y0 = cy * CHUNK;
+
+            c.cx = cx;
+            c.cy = cy;
+            c.used = true;
+            c.level = level;
+
+            Shapes::LodScope lod(Shapes::lodLevelPixels(level));
+            RenderBatch::Vertex *const first = &verts[(size_t)slot * vertsPerChunk()];
+            RenderBatch::Vertex *out = first;
+            for (int i = 0; i < perChunk; i++) {
+                Star s;
+                s.x = x0 + rng.range(0.0f, CHUNK);
+                s.y = y0 + rng.range(0.0f, CHUNK);
+
+                // subtle star colors
+                float tint = rng.range(0.8f, 1.0f);
+                s.r = tint;
+                s.g = tint;
+                s.b = rng.range(0.85f, 1.0f);
+
+                s.size = rng.range(0.006f, 0.02f);
+                s.parallax = rng.range(0.25f, 1.0f);
+
+                out = buildStar(s, out);
+            }
+            c.starVertCount = (int)(out - first);
 
-    void spawnMeteor(const Player &player) {
-        meteor.active = true;
+            // about 10 planets per 20 x 20, like the old wrapped set
+            c.hasPlanet = rng.unit() < 0.4f;
+            if (c.hasPlanet) c.planet = makePlanet(rng, x0, y0);
+        }
 
-        // start from top-left-ish off screen and cross
-        float startRange = 2.8f;
-        meteor.x = player.x + rf(-startRange, startRange);
-        meteor.y = player.y + rf(2.0f, 3.4f);
+        // same triangles as Shapes::Circle(batch, s.size, STAR_SEGMENTS) at the
+        // current LOD; returns the end of what it wrote
+        static RenderBatch::Vertex *buildStar(const Star &s, RenderBatch::Vertex *out) {
+            const int n = Shapes::lodSegments(s.size, STAR_SEGMENTS);
+            const float *cs = CircleTable::at(n);
+            RenderBatch::Vertex v;
+            v.r = toByte(s.r); v.g = toByte(s.g); v.b = toByte(s.b); v.a = 255;
+
+            for (int i = 1; i <= n; i++) {
+                v.x = s.x;                           v.y = s.y;                           *out++ = v;
+                v.x = s.x + s.size * cs[2*i - 2];    v.y = s.y + s.size * cs[2*i - 1];    *out++ = v;
+                v.x = s.x + s.size * cs[2*i];        v.y = s.y + s.size * cs[2*i + 1];    *out++ = v;
+            }
+            return out;
+        }
 
-        // velocity diagonally downward
-        meteor.vx = rf(0.03f, 0.06f);
-        meteor.vy = rf(-0.08f, -0.05f);
+        static Planet makePlanet(Rng &rng, float x0, float y0) {
+            Planet p;
 
-        meteor.size = rf(0.03f, 0.07f);
-        meteor.life = 140.0f; // frames
-    }
+            p.x = x0 + rng.range(0.0f, CHUNK);
+            p.y = y0 + rng.range(0.0f, CHUNK);
 
-    void drawMeteor() const {
-        // head
-        glColor3f(1.0f, 0.9f, 0.6f);
-        glPushMatrix();
-        glTranslatef(meteor.x, meteor.y, 0.0f);
-        Shapes::Circle(meteor.size, 20);
-        glPopMatrix();
+            p.radius = rng.range(0.12f, 0.45f);
+            p.r = rng.range(0.2f, 1.0f);
+            p.g = rng.range(0.2f, 1.0f);
+            p.b = rng.range(0.2f, 1.0f);
 
-        // tail (3 fading circles)
-        for (int i = 1; i <= 3; i++) {
-            float f = 1.0f - i * 0.25f;
-            glColor3f(1.0f * f, 0.7f * f, 0.3f * f);
+            p.parallax = rng.range(0.08f, 0.20f);
 
-            glPushMatrix();
-            glTranslatef(meteor.x - meteor.vx * i * 10.0f, meteor.y - meteor.vy * i * 10.0f, 0.0f);
-            Shapes::Circle(meteor.size * (0.9f - i * 0.15f), 16);
-            glPopMatrix();
+            p.moons = rng.below(3); // 0..2
+            p.moonDist = p.radius + rng.range(0.10f, 0.25f);
+            p.moonRadius = rng.range(0.03f, 0.07f);
+            p.moonSpeed = rng.range(0.02f, 0.05f);
+            p.moonPhase = rng.range(0.0f, 6.28f);
+
+            return p;
         }
-    }
 
-    void wrapStars(const Player &player) {
-        float wrapR = 8.0f;
-        for (auto &s : stars) {
-            float dx = s.x - player.x;
-            float dy = s.y - player.y;
+        static unsigned char toByte(float c) {
+            c = std::max(0.0f, std::min(1.0f, c));
+            return (unsigned char)(c * 255.0f + 0.5f);
+        }
+    };
+
+    uint64_t runSeed = 0;
+    std::shared_ptr<ChunkCache> chunks;
 
-            if (dx > wrapR) s.x -= 2 * wrapR;
-            if (dx < -wrapR) s.x += 2 * wrapR;
-            if (dy > wrapR) s.y -= 2 * wrapR;
-            if (dy < -wrapR) s.y += 2 * wrapR;
+    // --------- helpers ----------
+    float rf(float a, float b) {
+        return rng.range(a, b);
+    }
 
+    int starsPerChunk() const {
+        return std::max(0, (int)std::lround(starCount * (CHUNK * CHUNK) / 256.0f));
+    }
 
+    // biggest planet + moon orbit, so a planet whose chunk is just off screen
+    // can still hang into view
+    static constexpr float PLANET_REACH = 0.45f + 0.25f + 0.07f;
+
+    // Every chunk that overlaps the view (widened by PLANET_REACH), but never
+    // more than the cache holds: a camera tilted towards the horizon keeps
+    // the 7 x 7 around the middle of the view.
+    template <class Fn>
+    void forVisible(const ViewRect &view, Fn fn) const {
+        const float lim = 1e6f;   // ViewRect::everything() is not a range
+        int c0x = (int)std::floor(std::max(view.x0 - PLANET_REACH, -lim) / CHUNK);
+        int c1x = (int)std::floor(std::min(view.x1 + PLANET_REACH,  lim) / CHUNK);
+        int c0y = (int)std::floor(std::max(view.y0 - PLANET_REACH, -lim) / CHUNK);
+        int c1y = (int)std::floor(std::min(view.y1 + PLANET_REACH,  lim) / CHUNK);
+
+        // 7 x 7 = 49 fits into MAX_CHUNKS with room to spare
+        const int MAX_SPAN = 7;
+        if (c1x - c0x + 1 > MAX_SPAN) { int mid = (c0x + c1x) / 2; c0x = mid - MAX_SPAN / 2; c1x = c0x + MAX_SPAN - 1; }
+        if (c1y - c0y + 1 > MAX_SPAN) { int mid = (c0y + c1y) / 2; c0y = mid - MAX_SPAN / 2; c1y = c0y + MAX_SPAN - 1; }
+
+        chunks->frame++;
+        const int per = starsPerChunk();
+        const int level = Shapes::lodLevel();
+        for (int cy = c0y; cy <= c1y; cy++) {
+            for (int cx = c0x; cx <= c1x; cx++) {
+                fn(chunks->get(cx, cy, runSeed, per, level));
+            }
         }
     }
 
-   void wrapPlanets(const Player &player) {
-    float wrapR = 10.0f;
+    void drawPlanet(RenderBatch &batch, const Planet &p) const {
+        batch.color(p.r, p.g, p.b);
+        batch.push();
+        batch.translate(p.x, p.y);
+        Shapes::Circle(batch, p.radius, 60);
+        batch.pop();
+
+        // moons
+        float phase = p.moonPhase + p.moonSpeed * ticks;
+        for (int m = 0; m < p.moons; m++) {
+            float ph = phase + m * 3.14159f * 0.7f;
+            float mx = p.x + std::cos(ph) * p.moonDist;
+            float my = p.y + std::sin(ph) * p.moonDist;
+
+            batch.color(0.95f, 0.95f, 0.95f); // moon color
+            batch.push();
+            batch.translate(mx, my);
+            Shapes::Circle(batch, p.moonRadius, 30);
+            batch.pop();
+        }
+    }
 
-    for (auto &p : planets) {
-        float dx = p.x - player.x;
-        float dy = p.y - player.y;
+    void spawnMeteor(const Player &player) {
+        // start from top-left-ish off screen and cross
+        float startRange = 2.8f;
+        float x = player.x + rf(-startRange, startRange);
+        float y = player.y + rf(2.0f, 3.4f);
 
-        // Only wrap when it goes far out of the area (infinite world effect)
-        if (dx > wrapR)  p.x -= 2 * wrapR;
-        if (dx < -wrapR) p.x += 2 * wrapR;
-        if (dy > wrapR)  p.y -= 2 * wrapR;
-        if (dy < -wrapR) p.y += 2 * wrapR;
+        // velocity diagonally downward
+        float vx = rf(0.03f, 0.06f);
+        float vy = rf(-0.08f, -0.05f);
 
-        // ✅ DO NOT push planets away when player gets close
-        // (Removed the "keep planets away from player zone" block)
+        Meteor m;
+        m.size = rf(0.03f, 0.07f);
+        meteors.spawn(x, y, vx, vy, 140.0f, m); // 140 frames
     }
-}
 
-};
+    void drawMeteor(RenderBatch &batch, Movers<Meteor>::ConstRef meteor) const {
+        // head
+        batch.color(1.0f, 0.9f, 0.6f);
+        batch.push();
+        batch.translate(meteor.x, meteor.y);
+        Shapes::Circle(batch, meteor.extra.size, 20);
+        batch.pop();
+
+        // tail (3 fading circles)
+        for (int i = 1; i <= 3; i++) {
+            float f = 1.0f - i * 0.25f;
+            batch.color(1.0f * f, 0.7f * f, 0.3f * f);
 
+            batch.push();
+            batch.translate(meteor.x - meteor.vx * i * 10.0f, meteor.y - meteor.vy * i * 10.0f);
+            Shapes::Circle(batch, meteor.extra.size * (0.9f - i * 0.15f), 16);
+            batch.pop();
+        }
+    }
+};
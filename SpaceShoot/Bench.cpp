@@ -0,0 +1,567 @@
+// Micro benchmarks for simulation hot paths (separate build target, no window).
+// Like Headless.cpp it only needs the GL headers to compile:
+//     g++ -std=c++17 -O2 Bench.cpp -o SpaceShootBench
+//
+// usage: SpaceShootBench [--filter text] [--min-time seconds] [--json file]
+//
+// --json writes every result in Google Benchmark's JSON layout (name, iterations,
+// real_time in ns per op, plus items = entities per op), so runs from two
+// commits can be diffed with its compare.py or any JSON tool.
+
+#include <GL/glut.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+#include "Rng.cpp"
+#include "Text.cpp"
+#include "Profiler.cpp"
+#include "Pool.cpp"
+#include "Arena.cpp"
+#include "JobSystem.cpp"
+#include "Movers.cpp"
+#include "Shapes.cpp"
+#include "ViewRect.cpp"
+#include "Player.cpp"
+#include "Movement.cpp"
+#include "PlayerMove.cpp"
+#include "Background.cpp"
+#include "EnemySystem.cpp"
+#include "Scoreboard.cpp"
+#include "Shooting.cpp"
+#include "Effects.cpp"
+#include "Collision.cpp"
+#include "EnemyCombat.cpp"
+#include "Simulation.cpp"
+#include "AudioMixer.cpp"
+
+class Bench {
+public:
+    std::string filter;
+    double minTime = 0.25;   // seconds per case
+
+    struct Result {
+        std::string name;
+        int n;
+        long calls;
+        double ns;   // per call
+    };
+    std::vector<Result> results;
+
+    // Times fn() until minTime has passed, returns ns per call.
+    template <class Fn>
+    double timeIt(Fn fn, long &calls) const {
+        using clock = std::chrono::steady_clock;
+
+        fn();   // warm up caches / vectors
+
+        calls = 0;
+        long batch = 1;
+        auto t0 = clock::now();
+        double elapsed = 0.0;
+        while (elapsed < minTime) {
+            for (long i = 0; i < batch; i++) fn();
+            calls += batch;
+            batch *= 2;
+            elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+        }
+        return elapsed * 1e9 / (double)calls;
+    }
+
+    bool wants(const char *name) const {
+        return filter.empty() || std::strstr(name, filter.c_str()) != nullptr;
+    }
+
+    void report(const char *name, int n, double ns) const {
+        std::printf("%-26s n=%6d  %12.1f ns/op  %8.2f ns/entity\n", name, n, ns, ns / std::max(n, 1));
+    }
+
+    template <class Fn>
+    void run(const char *name, int n, Fn fn) {
+        if (!wants(name)) return;
+        long calls;
+        double ns = timeIt(fn, calls);
+        report(name, n, ns);
+        results.push_back({ name, n, calls, ns });
+    }
+
+    bool writeJson(const char *path) const {
+        std::FILE *f = std::fopen(path, "w");
+        if (!f) return false;
+
+        std::fprintf(f, "{\n  \"context\": { \"executable\": \"SpaceShootBench\", \"min_time\": %g },\n", minTime);
+        std::fprintf(f, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &r = results[i];
+            std::fprintf(f, "    { \"name\": \"%s/%d\", \"run_type\": \"iteration\", \"iterations\": %ld, "
+                            "\"real_time\": %.3f, \"cpu_time\": %.3f, \"time_unit\": \"ns\", \"items\": %d }%s\n",
+                         r.name.c_str(), r.n, r.calls, r.ns, r.ns, r.n, i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(f, "  ]\n}\n");
+        std::fclose(f);
+        return true;
+    }
+
+    // EnemySystem internals (Bench is a friend), so the stages of update()
+    // can be timed one at a time
+    static void separate(EnemySystem &es) { es.applySeparation(); }
+    static void spawn(EnemySystem &es, const Player &p, float zoom, float aspect) { es.spawnOne(p, zoom, aspect); }
+    static bool overlaps(const EnemySystem &es, const EnemySystem::Enemy &e) { return es.overlapsAny(e); }
+
+    // enemy geometry built shape by shape, the way draw() worked before the cached meshes
+    static void buildEnemies(const EnemySystem::Store &s, RenderBatch &batch) {
+        batch.reset();
+        for (int i = 0; i < (int)s.size(); i++) {
+            batch.push();
+            batch.translate(s.x[i], s.y[i] + 0.03f * std::sin(s.wobblePhase[i]));
+            switch (s.type[i]) {
+                case EnemySystem::MONSTER_A: EnemySystem::buildMonsterA(batch); break;
+                case EnemySystem::MONSTER_B: EnemySystem::buildMonsterB(batch); break;
+                case EnemySystem::MONSTER_C: EnemySystem::buildMonsterC(batch); break;
+            }
+            batch.pop();
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// fixtures
+
+static Rng benchRng;
+
+// results nothing else reads go here, so the optimizer cannot drop the work
+static volatile long benchSink = 0;
+
+static float benchRand(float a, float b) {
+    return benchRng.range(a, b);
+}
+
+// n enemies scattered in a disc of the given radius around the origin
+static void fillEnemies(EnemySystem &es, int n, float spread) {
+    es.init(1);
+    es.maxEnemies = std::max(es.maxEnemies, n);
+    benchRng.seed(12345, Rng::BENCH);
+
+    for (int i = 0; i < n; i++) {
+        EnemySystem::Enemy e;
+        e.type = (EnemySystem::Type)(i % 3);
+        float a = benchRand(0.0f, 6.2831853f);
+        float r = spread * std::sqrt(benchRand(0.0f, 1.0f));
+        e.x = r * std::cos(a);
+        e.y = r * std::sin(a);
+        e.vx = e.vy = 0.0f;
+        e.speed = benchRand(0.009f, 0.018f);
+        e.radius = 0.12f + 0.01f * (float)(i % 3);
+        e.r = e.g = e.b = 1.0f;
+        e.wobblePhase = benchRand(0.0f, 6.28f);
+        es.enemies.push_back(e);
+    }
+}
+
+// crowd density roughly like a real horde, scaled so n enemies keep it
+static float crowdSpread(int n) {
+    return 3.0f * std::sqrt((float)n / 240.0f);
+}
+
+// The chase loop as it was over an array of structs, kept as the baseline.
+struct AosEnemy {
+    int type;
+    float x, y, vx, vy, speed, radius, r, g, b, wobblePhase;
+    int shootCD, touchCD;
+};
+
+static void chaseAos(std::vector<AosEnemy> &v, float px, float py) {
+    for (auto &e : v) {
+        e.wobblePhase += 0.05f;
+
+        float dx = px - e.x;
+        float dy = py - e.y;
+        float d = std::sqrt(dx*dx + dy*dy) + 1e-6f;
+
+        float ux = dx / d;
+        float uy = dy / d;
+
+        e.vx = e.vx + (ux * e.speed - e.vx) * 0.07f;
+        e.vy = e.vy + (uy * e.speed - e.vy) * 0.07f;
+
+        e.x += e.vx;
+        e.y += e.vy;
+    }
+}
+
+// Shapes::Circle as it was before the unit-circle table: cos + sin per vertex.
+static void circleTrig(RenderBatch &b, float r, int segments) {
+    float px = r, py = 0.0f;
+    for (int i = 1; i <= segments; i++) {
+        float t = 2.0f * 3.1415926f * i / segments;
+        float x = r * std::cos(t), y = r * std::sin(t);
+        b.tri(0.0f, 0.0f, px, py, x, y);
+        px = x; py = y;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// cases
+
+static void benchChase(Bench &bench) {
+    static const int counts[] = { 1000, 3000, 10000 };
+
+    for (int n : counts) {
+        static EnemySystem es;
+        fillEnemies(es, n, crowdSpread(n));
+
+        std::vector<AosEnemy> aos(n);
+        for (int i = 0; i < n; i++) {
+            EnemySystem::Enemy e = es.enemies.at(i);
+            aos[i] = { (int)e.type, e.x, e.y, e.vx, e.vy, e.speed, e.radius,
+                       e.r, e.g, e.b, e.wobblePhase, e.shootCD, e.touchCD };
+        }
+
+        bench.run("chase/aos_scalar", n, [&] { chaseAos(aos, 0.0f, 0.0f); });
+        bench.run("chase/soa_scalar", n, [&] { EnemySystem::chaseScalar(es.enemies, 0, n, 0.0f, 0.0f); });
+        bench.run("chase/soa_simd", n, [&] { es.chase(0.0f, 0.0f); });
+    }
+}
+
+// n circles per op at the segment counts the game uses (stars 10, enemies 40,
+// planets / player 60), with and without the screen-size LOD; geometry only,
+// the batch is cleared instead of drawn
+static void benchCircles(Bench &bench) {
+    static const int segs[] = { 10, 40, 60 };
+    const int n = 1000;
+    RenderBatch batch;
+
+    for (int s : segs) {
+        char name[64];
+
+        std::snprintf(name, sizeof(name), "circle%d/trig", s);
+        bench.run(name, n, [&] {
+            batch.clear();
+            for (int i = 0; i < n; i++) circleTrig(batch, 0.1f, s);
+        });
+
+        std::snprintf(name, sizeof(name), "circle%d/table", s);
+        bench.run(name, n, [&] {
+            batch.clear();
+            for (int i = 0; i < n; i++) Shapes::Circle(batch, 0.1f, s);
+        });
+
+        // as display() draws them at the default zoom, 480 pixels high
+        std::snprintf(name, sizeof(name), "circle%d/lod", s);
+        bench.run(name, n, [&] {
+            Shapes::LodScope lod(Shapes::pixelsPerUnitAt(2.0f, 480));
+            batch.clear();
+            for (int i = 0; i < n; i++) Shapes::Circle(batch, 0.1f, s);
+        });
+    }
+}
+
+// entity counts for the per-system cases below
+static const int COUNTS[] = { 100, 300, 1000, 10000 };
+
+// geometry for n enemies: every shape rebuilt vs stamped from the cached meshes
+static void benchEnemyGeometry(Bench &bench) {
+    RenderBatch batch;
+    for (int n : COUNTS) {
+        static EnemySystem es;
+        fillEnemies(es, n, crowdSpread(n));
+
+        bench.run("enemies/geometry_shapes", n, [&] {
+            batch.clear();
+            Bench::buildEnemies(es.enemies, batch);
+        });
+        bench.run("enemies/geometry_meshes", n, [&] {
+            batch.clear();
+            EnemySystem::emit(es.enemies, batch);
+        });
+    }
+}
+
+// one full EnemySystem::update (spawn check, chase, separation) on a steady horde
+static void benchEnemyUpdate(Bench &bench) {
+    Player player;
+    for (int n : COUNTS) {
+        static EnemySystem es;
+        fillEnemies(es, n, crowdSpread(n));
+        es.maxEnemies = n;   // full, so the count stays put
+
+        bench.run("enemies/update", n, [&] { es.update(player, 2.0f, 640.0f / 480.0f); });
+    }
+}
+
+static void benchSeparation(Bench &bench) {
+    for (int n : COUNTS) {
+        static EnemySystem es;
+        fillEnemies(es, n, crowdSpread(n));
+
+        bench.run("enemies/separation", n, [&] { Bench::separate(es); });
+    }
+}
+
+// spawning into a horde of n: spawnOne (up to 30 overlap probes) then drop the
+// newcomer again; overlapsAny alone for one probe at a random spot in the crowd
+static void benchSpawn(Bench &bench) {
+    Player player;
+    for (int n : COUNTS) {
+        static EnemySystem es;
+        float spread = crowdSpread(n);
+        fillEnemies(es, n, spread);
+        es.rebuildGrid();
+
+        bench.run("enemies/spawnOne", n, [&] {
+            Bench::spawn(es, player, 2.0f, 640.0f / 480.0f);
+            while ((int)es.enemies.size() > n) es.enemies.swapRemove((int)es.enemies.size() - 1);
+        });
+
+        EnemySystem::Enemy probe = es.enemies.at(0);
+        bench.run("enemies/overlapsAny", n, [&] {
+            probe.x = benchRand(-spread, spread);
+            probe.y = benchRand(-spread, spread);
+            benchSink = benchSink + Bench::overlaps(es, probe);
+        });
+    }
+}
+
+// 64 bullets (a busy moment, ~36 is usual) fired through a horde of n. Hits
+// remove enemies and bullets, so every op restores both first; collision/restore
+// is that copy alone, subtract it.
+static void benchCollision(Bench &bench) {
+    for (int n : COUNTS) {
+        static EnemySystem es, start;
+        float spread = crowdSpread(n);
+        fillEnemies(start, n, spread);
+        es = start;
+
+        Shooting sh, shStart;
+        for (int i = 0; i < 64; i++) {
+            float a = benchRand(0.0f, 6.2831853f);
+            float x = benchRand(-spread, spread);
+            float y = benchRand(-spread, spread);
+            shStart.bullets.spawn(x, y, 0.22f * std::cos(a), 0.22f * std::sin(a), 100.0f);
+        }
+
+        Arena scratch(64 * 1024);
+        Collision col;
+        col.scratch = &scratch;
+        Effects fx;
+        Scoreboard hud;
+
+        bench.run("collision/restore", n, [&] {
+            es.enemies = start.enemies;
+            sh.bullets = shStart.bullets;
+        });
+        bench.run("collision/bulletEnemy", n, [&] {
+            es.enemies = start.enemies;
+            sh.bullets = shStart.bullets;
+            hud.reset();
+            col.bulletEnemy(sh, es, fx, hud);
+            scratch.reset();
+        });
+    }
+}
+
+// firing, touch damage, bullet flight and bullet-vs-player for n enemies
+static void benchEnemyCombat(Bench &bench) {
+    for (int n : COUNTS) {
+        static EnemySystem es;
+        fillEnemies(es, n, crowdSpread(n));
+        EnemyCombat combat;
+        combat.init(1);
+        Player player;
+
+        bench.run("enemyCombat/update", n, [&] {
+            player.hp = 100;
+            player.invuln = 0;
+            combat.update(es, player);
+        });
+    }
+}
+
+// the booms pool holds Effects::MAX_BOOMS, so only counts that fit
+static void benchEffects(Bench &bench) {
+    for (int n : COUNTS) {
+        if (n > Effects::MAX_BOOMS) continue;
+
+        Effects fx;
+        bench.run("effects/update", n, [&] {
+            fx.update();
+            while (fx.booms.size() < n) fx.spawn(benchRand(-3.0f, 3.0f), benchRand(-3.0f, 3.0f));
+        });
+    }
+}
+
+// The integrate + sweep systems against the per-kind loop they replaced (a
+// Pool of structs, x += vx ... then removeIf), on n bullets with staggered
+// lives so a few die and get replaced every tick, as in play.
+static void benchMovers(Bench &bench) {
+    struct Old { float x, y, vx, vy, life, angleDeg; };
+
+    for (int n : COUNTS) {
+        Pool<Old> old(n);
+        Movers<Shooting::Look> movers(n);
+        for (int i = 0; i < n; i++) {
+            Old o;
+            o.x = benchRand(-3.0f, 3.0f); o.y = benchRand(-3.0f, 3.0f);
+            o.vx = benchRand(-0.2f, 0.2f); o.vy = benchRand(-0.2f, 0.2f);
+            o.life = (float)(1 + i % 140);
+            o.angleDeg = 0.0f;
+            old.spawn(o);
+            movers.spawn(o.x, o.y, o.vx, o.vy, o.life);
+        }
+
+        bench.run("movers/struct", n, [&] {
+            for (auto &b : old) {
+                b.x += b.vx;
+                b.y += b.vy;
+                b.life -= 1.0f;
+            }
+            old.removeIf([](const Old &b) { return b.life <= 0.0f; });
+            while (old.size() < n) {
+                Old o = { 0.0f, 0.0f, 0.1f, 0.1f, 140.0f, 0.0f };
+                old.spawn(o);
+            }
+        });
+        bench.run("movers/integrate", n, [&] {
+            movers.integrate(1.0f);
+            movers.sweep();
+            while (movers.size() < n) movers.spawn(0.0f, 0.0f, 0.1f, 0.1f, 140.0f);
+        });
+    }
+}
+
+// n short scratch vectors (16 ints each, Collision's kind) per op, from the
+// heap and from an Arena that is reset after every op as Simulation::tick does
+static void benchScratch(Bench &bench) {
+    Arena arena(64 * 1024);
+    for (int n : COUNTS) {
+        bench.run("scratch/heap", n, [&] {
+            for (int k = 0; k < n; k++) {
+                std::vector<int> v;
+                v.reserve(16);
+                for (int i = 0; i < 16; i++) v.push_back(i + k);
+                benchSink = benchSink + v[k & 15];
+            }
+        });
+        bench.run("scratch/arena", n, [&] {
+            for (int k = 0; k < n; k++) {
+                ArenaVector<int> v{ArenaAllocator<int>(&arena)};
+                v.reserve(16);
+                for (int i = 0; i < 16; i++) v.push_back(i + k);
+                benchSink = benchSink + v[k & 15];
+            }
+            arena.reset();
+        });
+    }
+}
+
+// n kills from a fresh run (level-ups included)
+static void benchScoreboard(Bench &bench) {
+    for (int n : COUNTS) {
+        Scoreboard hud;
+        bench.run("scoreboard/addKill", n, [&] {
+            hud.reset();
+            for (int i = 0; i < n; i++) hud.addKill(1);
+            benchSink = benchSink + hud.level;
+        });
+    }
+}
+
+// Background chunks around a camera flying at 0.25 units per frame (a new
+// column of chunks every 16 frames), n = star density as in --stars
+static void benchBackground(Bench &bench) {
+    static const int stars[] = { 160, 10000, 50000 };
+    for (int n : stars) {
+        static Background bg;
+        bg.starCount = n;
+        bg.init(1);
+
+        float x = 0.0f;
+        bench.run("background/chunks", n, [&] {
+            x += 0.25f;
+            ViewRect view = ViewRect::fromCamera(x, 0.0f, 2.0f, 640.0f / 480.0f, 0.0f, 0.0f);
+            benchSink = benchSink + bg.prepare(view);
+        });
+    }
+}
+
+// one mixer block (AudioMixer::BLOCK frames) with n looping voices playing
+static void benchAudioMix(Bench &bench) {
+    static const int voices[] = { 1, 4, 16 };
+
+    // one second of a 440 Hz tone
+    Sample tone;
+    tone.pcm.resize(Sample::RATE * 2);
+    for (int i = 0; i < Sample::RATE; i++) {
+        short v = (short)(8000.0f * std::sin(i * 2.0f * 3.1415926f * 440.0f / Sample::RATE));
+        tone.pcm[i * 2] = tone.pcm[i * 2 + 1] = v;
+    }
+
+    short pcm[AudioMixer::BLOCK * 2];
+    for (int n : voices) {
+        static AudioMixer mixer;
+        static int sound = mixer.addSound(tone);
+        mixer.stopTag(1);
+        for (int v = 0; v < n; v++) mixer.play(sound, 0.5f, true, 1);
+
+        bench.run("audio/mix", n, [&] {
+            mixer.render(pcm, AudioMixer::BLOCK);
+            benchSink = benchSink + pcm[0];
+        });
+    }
+
+    // n hit triggers per block, as a big wave dies: they coalesce into one
+    // voice, so the cost should hardly move with n
+    static const int triggers[] = { 1, 16, 200 };
+    for (int n : triggers) {
+        static AudioMixer mixer;
+        static int hit = mixer.addSound(tone, 4, 1);
+
+        bench.run("audio/hit_burst", n, [&] {
+            for (int i = 0; i < n; i++) mixer.play(hit);
+            mixer.render(pcm, AudioMixer::BLOCK);
+            benchSink = benchSink + pcm[0];
+        });
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Bench bench;
+    const char *jsonPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) bench.filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) bench.minTime = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else {
+            std::fprintf(stderr, "usage: %s [--filter text] [--min-time seconds] [--json file]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    benchChase(bench);
+    benchCircles(bench);
+    benchEnemyGeometry(bench);
+
+    benchEnemyUpdate(bench);
+    benchSeparation(bench);
+    benchSpawn(bench);
+    benchCollision(bench);
+    benchEnemyCombat(bench);
+    benchEffects(bench);
+    benchMovers(bench);
+    benchScratch(bench);
+    benchScoreboard(bench);
+    benchBackground(bench);
+    benchAudioMix(bench);
+
+    if (jsonPath && !bench.writeJson(jsonPath)) {
+        std::fprintf(stderr, "cannot write %s\n", jsonPath);
+        return 1;
+    }
+    return 0;
+}
@@ -1,43 +1,95 @@
+#include <vector>
 #include <cmath>
 #include <algorithm>
 
 class Collision {
 public:
+    // per-tick scratch, set by Simulation (null = the heap)
+    Arena *scratch = nullptr;
+
     void bulletEnemy(Shooting &shooting, EnemySystem &enemies, Effects &fx, Scoreboard &hud) {
         const float bulletR = 0.03f;
 
-        for (int bi = (int)shooting.bullets.size() - 1; bi >= 0; --bi) {
-            auto &b = shooting.bullets[bi];
+        auto &bullets = shooting.bullets;
+        auto &list = enemies.enemies;
+        if (bullets.empty() || list.empty()) return;
 
-            bool bulletRemoved = false;
+        // broadphase: the enemy grid (positions are final for this tick)
+        enemies.rebuildGrid();
 
-            for (int ei = (int)enemies.enemies.size() - 1; ei >= 0; --ei) {
-                auto &e = enemies.enemies[ei];
+        // every bullet takes at most one enemy, so these never grow
+        ArenaVector<char> enemyDead(list.size(), 0, ArenaAllocator<char>(scratch));
+        ArenaVector<int> deadEnemies{ArenaAllocator<int>(scratch)};
+        ArenaVector<int> deadBullets{ArenaAllocator<int>(scratch)};
+        deadEnemies.reserve(bullets.size());
+        deadBullets.reserve(bullets.size());
 
-                float dx = b.x - e.x;
-                float dy = b.y - e.y;
-                float rr = bulletR + e.radius;
+        const float reach = bulletR + EnemySystem::MAX_RADIUS;
 
-                if (dx*dx + dy*dy <= rr*rr) {
-                    // explosion
-                    fx.spawn(e.x, e.y);   // <-- if your Effects uses another name, rename this call
+        for (auto it = bullets.begin(); it != bullets.end(); ++it) {
+            const auto &b = *it;
 
-                    // remove enemy
-                    enemies.enemies.erase(enemies.enemies.begin() + ei);
+            // swept: the bullet moved from (x0,y0) to (b.x,b.y) this tick, at
+            // 0.22/tick it would otherwise skip straight over small enemies
+            float x0 = b.x - b.vx;
+            float y0 = b.y - b.vy;
 
-                    // remove bullet
-                    shooting.bullets.erase(shooting.bullets.begin() + bi);
-                    bulletRemoved = true;
+            int hit = -1;
+            float hitT = 2.0f;
 
-                    // score + level logic
-                    hud.addKill(1);
+            enemies.grid.query(std::min(x0, b.x) - reach, std::min(y0, b.y) - reach,
+                               std::max(x0, b.x) + reach, std::max(y0, b.y) + reach,
+                               [&](int ei, float ex, float ey, float er) {
+                if (enemyDead[ei]) return false;
 
-                    break;
+                float t;
+                if (sweptCircle(x0, y0, b.vx, b.vy, ex, ey, bulletR + er, t) && t < hitT) {
+                    hitT = t;   // first enemy along the path takes the bullet
+                    hit = ei;
                 }
-            }
+                return false;
+            });
+
+            if (hit < 0) continue;
+
+            // explosion
+            fx.spawn(list.x[hit], list.y[hit]);
+
+            enemyDead[hit] = 1;
+            deadEnemies.push_back(hit);
+            deadBullets.push_back(it.slot());
+
+            // score + level logic
+            hud.addKill(1);
+        }
 
-            if (bulletRemoved) continue;
+        // enemies: deferred swap-and-pop, highest index first so the rest stay valid
+        std::sort(deadEnemies.begin(), deadEnemies.end());
+        for (int k = (int)deadEnemies.size() - 1; k >= 0; --k) {
+            list.swapRemove(deadEnemies[k]);
         }
+        for (int slot : deadBullets) bullets.kill(slot);   // pool slots never move
     }
 
+private:
+    // Does a point moving from (x0,y0) by (vx,vy) come within r of (cx,cy)?
+    // t = fraction of the move (0..1) where it first touches.
+    static bool sweptCircle(float x0, float y0, float vx, float vy,
+                            float cx, float cy, float r, float &t) {
+        float fx = x0 - cx;
+        float fy = y0 - cy;
+
+        float c = fx*fx + fy*fy - r*r;
+        if (c <= 0.0f) { t = 0.0f; return true; }   // already touching
+
+        float a = vx*vx + vy*vy;
+        if (a < 1e-12f) return false;
+
+        float b = 2.0f * (fx*vx + fy*vy);
+        float disc = b*b - 4.0f*a*c;
+        if (disc < 0.0f) return false;
+
+        t = (-b - std::sqrt(disc)) / (2.0f * a);
+        return t >= 0.0f && t <= 1.0f;
+    }
 };
@@ -5,60 +5,47 @@
 
 class Effects {
 public:
-    struct Boom {
-        float x, y;
-        float t;      // 0..1
-        float life;   // decreases
-    };
+    // Booms stand still and only run out of life (1 -> 0, 0.06 per tick);
+    // their growth t is how far that has got.
+    static constexpr float LIFE_STEP = 0.06f;
+    static constexpr float GROW_STEP = 0.08f;
 
-    std::vector<Boom> booms;
+    // full = the oldest explosion makes room
+    static const int MAX_BOOMS = 300;
+    Movers<> booms{MAX_BOOMS};
 
     // ✅ Collision.cpp calls this
     void spawn(float x, float y) {
-        Boom b;
-        b.x = x; b.y = y;
-        b.t = 0.0f;
-        b.life = 1.0f;
-        booms.push_back(b);
+        booms.spawn(x, y, 0.0f, 0.0f, 1.0f);
     }
 
     void update() {
-        for (auto &b : booms) {
-            b.t += 0.08f;
-            b.life -= 0.06f;
-        }
-        booms.erase(
-            std::remove_if(booms.begin(), booms.end(),
-                           [](const Boom& b){ return b.life <= 0.0f; }),
-            booms.end()
-        );
+        booms.integrate(LIFE_STEP);
+        booms.sweep();
     }
 
-    void draw() const {
+    // returns how many explosions were on screen (the rest are culled)
+    int draw(RenderBatch &batch, const ViewRect &view = ViewRect::everything()) const {
+        batch.reset();
+
+        int drawn = 0;
         for (const auto &b : booms) {
-            float r = 0.04f + 0.14f * b.t;
+            float t = (1.0f - b.life) * (GROW_STEP / LIFE_STEP);
+            float r = 0.04f + 0.14f * t;
+            if (!view.visible(b.x, b.y, r + 0.02f)) continue;
+            drawn++;
+
             float alpha = std::max(0.0f, b.life);
 
             // simple ring explosion
-            glColor3f(1.0f, 0.6f * alpha, 0.1f * alpha);
-            glPushMatrix();
-            glTranslatef(b.x, b.y, 0.0f);
-            drawRing(r, r + 0.02f);
-            glPopMatrix();
+            batch.color(1.0f, 0.6f * alpha, 0.1f * alpha);
+            batch.push();
+            batch.translate(b.x, b.y);
+            Shapes::Ring(batch, r, r + 0.02f, 40);
+            batch.pop();
         }
-    }
 
-private:
-    static void drawRing(float r1, float r2) {
-        const int N = 40;
-        glBegin(GL_TRIANGLE_STRIP);
-        for (int i = 0; i <= N; i++) {
-            float a = (float)i / (float)N * 2.0f * 3.1415926f;
-            float cx = std::cos(a);
-            float cy = std::sin(a);
-            glVertex2f(cx * r1, cy * r1);
-            glVertex2f(cx * r2, cy * r2);
-        }
-        glEnd();
+        batch.flush();
+        return drawn;
     }
 };
@@ -2,17 +2,12 @@
 #include <vector>
 #include <cmath>
 #include <algorithm>
-#include <cstdlib>
 
 class EnemyCombat {
 public:
-    struct EBullet {
-        float x, y;
-        float vx, vy;
-        float life;     // frames remaining
-    };
-
-    std::vector<EBullet> bullets;
+    // full = the oldest bullet makes room (was an erase() cap in the tick)
+    static const int MAX_BULLETS = 800;
+    Movers<> bullets{MAX_BULLETS};   // life = frames remaining
 
     // tune values
     float bulletSpeed = 0.020f;     // ✅ slower than player bullet
@@ -27,54 +22,59 @@ public:
     int bulletDamage = 2;
     int hp = 100;
 int invuln = 0;   // <-- add this (i-frames)
+    // fire cooldown rolls
+    Rng rng;
+
     // Clear all enemy bullets (used when starting a new run)
     void reset() { bullets.clear(); }
 
+    void init(uint64_t seed) {
+        rng.seed(seed, Rng::ENEMY_COMBAT);
+        bullets.clear();
+    }
+
 
     int touchTickFrames = 18;       // ✅ continuous touch damage every ~0.3s at 60fps
 
     void update(EnemySystem &enemies, Player &player) {
         // ---- 1) enemy firing + touch damage ----
-        for (auto &e : enemies.enemies) {
+        auto &es = enemies.enemies;
+        for (int i = 0; i < (int)es.size(); i++) {
             // cooldown tick handled in EnemySystem.update(), but safe here too
-            if (e.shootCD > 0) e.shootCD--;
-            if (e.touchCD > 0) e.touchCD--;
+            if (es.shootCD[i] > 0) es.shootCD[i]--;
+            if (es.touchCD[i] > 0) es.touchCD[i]--;
 
-            float dx = player.x - e.x;
-            float dy = player.y - e.y;
+            float dx = player.x - es.x[i];
+            float dy = player.y - es.y[i];
             float d  = std::sqrt(dx*dx + dy*dy) + 1e-6f;
 
             // (A) TOUCH DAMAGE (zombie style continuous)
-            float touchDist = e.radius + playerR;
+            float touchDist = es.radius[i] + playerR;
             if (d < touchDist) {
                 // continuous glow
                 player.bodyHitT = 1.0f;
 
                 // continuous damage tick
-                if (e.touchCD <= 0) {
+                if (es.touchCD[i] <= 0) {
                     applyDamage(player, bulletDamage);  // same 2 damage
-                    e.touchCD = touchTickFrames;
+                    es.touchCD[i] = touchTickFrames;
                 }
             }
 
             // (B) SHOOTING (only if not too close)
             if (d < shootRangeMax && d > closeNoShoot) {
-                if (e.shootCD <= 0) {
-                    fireFromEnemy(e, player);
-                    e.shootCD = randRangeInt(shootCooldownMin, shootCooldownMax);
+                if (es.shootCD[i] <= 0) {
+                    fireFromEnemy(es.x[i], es.y[i], es.radius[i], player);
+                    es.shootCD[i] = randRangeInt(shootCooldownMin, shootCooldownMax);
                 }
             }
         }
 
-        // ---- 2) update bullets movement ----
-        for (auto &b : bullets) {
-            b.x += b.vx;
-            b.y += b.vy;
-            b.life -= 1.0f;
-        }
+        // ---- 2) update bullets movement (at most 800, ~1 ns each: not worth a job) ----
+        bullets.integrate(1.0f);
 
         // ---- 3) bullet vs player collision ----
-        for (auto &b : bullets) {
+        for (auto b : bullets) {
             float dx = b.x - player.x;
             float dy = b.y - player.y;
             float rr = bulletR + playerR;
@@ -89,49 +89,50 @@ int invuln = 0;   // <-- add this (i-frames)
         }
 
         // ---- 4) cleanup dead bullets ----
-        bullets.erase(
-            std::remove_if(bullets.begin(), bullets.end(),
-                           [](const EBullet& b){ return b.life <= 0.0f; }),
-            bullets.end()
-        );
+        bullets.sweep();
     }
 
-    void draw() const {
+    // alpha: 0 = previous tick, 1 = current (straight line, so prev = x - vx)
+    // returns how many bullets were on screen (the rest are culled)
+    int draw(RenderBatch &batch, float alpha = 1.0f, const ViewRect &view = ViewRect::everything()) const {
+        batch.reset();
+
         // danger red bullets
-        glColor3f(1.0f, 0.0f, 0.0f);
+        batch.color(1.0f, 0.0f, 0.0f);
 
+        const float back = 1.0f - alpha;
+        int drawn = 0;
         for (const auto &b : bullets) {
-            glPushMatrix();
-            glTranslatef(b.x, b.y, 0.0f);
+            float x = b.x - b.vx * back, y = b.y - b.vy * back;
+            float reach = bulletR + (std::fabs(b.vx) + std::fabs(b.vy)) * 10.0f;   // + tail
+            if (!view.visible(x, y, reach)) continue;
+            drawn++;
 
-            // simple glowing bullet: circle + small tail line
-            Shapes::Circle(bulletR, 18);
+            batch.push();
+            batch.translate(x, y);
 
-            glBegin(GL_LINES);
-            glVertex2f(0.0f, 0.0f);
-            glVertex2f(-b.vx * 10.0f, -b.vy * 10.0f);
-            glEnd();
+            // simple glowing bullet: circle + small tail line
+            Shapes::Circle(batch, bulletR, 18);
+            batch.line(0.0f, 0.0f, -b.vx * 10.0f, -b.vy * 10.0f);
 
-            glPopMatrix();
+            batch.pop();
         }
+
+        batch.flush();
+        return drawn;
     }
 
 private:
-    void fireFromEnemy(const EnemySystem::Enemy &e, const Player &player) {
-        float dx = player.x - e.x;
-        float dy = player.y - e.y;
+    void fireFromEnemy(float ex, float ey, float eRadius, const Player &player) {
+        float dx = player.x - ex;
+        float dy = player.y - ey;
         float d  = std::sqrt(dx*dx + dy*dy) + 1e-6f;
         float ux = dx / d;
         float uy = dy / d;
 
-        EBullet b;
-        b.x = e.x + ux * (e.radius + 0.02f);
-        b.y = e.y + uy * (e.radius + 0.02f);
-        b.vx = ux * bulletSpeed;
-        b.vy = uy * bulletSpeed;
-        b.life = 320.0f; // ~5 seconds
-
-        bullets.push_back(b);
+        bullets.spawn(ex + ux * (eRadius + 0.02f), ey + uy * (eRadius + 0.02f),
+                      ux * bulletSpeed, uy * bulletSpeed,
+                      320.0f); // ~5 seconds
     }
 
     void applyDamage(Player &player, int dmg) {
@@ -147,8 +148,7 @@ private:
         player.bodyHitT = 1.0f;
     }
 
-    static int randRangeInt(int a, int b) {
-        if (b <= a) return a;
-        return a + (std::rand() % (b - a + 1));
+    int randRangeInt(int a, int b) {
+        return rng.rangeInt(a, b);
     }
 };
@@ -1,16 +1,23 @@
 #include <GL/glut.h>
 #include <vector>
-#include <cstdlib>
-#include <ctime>
 #include <cmath>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENEMY_CHASE_SSE 1
+#endif
+
+#include "SpatialGrid.cpp"
+
 // NOTE: Shapes is expected to be available because main.cpp includes Shapes.cpp first.
 
 class EnemySystem {
 public:
     enum Type { MONSTER_A = 0, MONSTER_B = 1, MONSTER_C = 2 };
 
+    // One enemy as a plain struct. Only used to build a new enemy and to hand
+    // one to the draw code, storage is the arrays in Store.
     struct Enemy {
         Type type;
         float x, y;
@@ -24,10 +31,109 @@ int touchCD = 0;
 
     };
 
-    std::vector<Enemy> enemies;
+    // Structure-of-arrays storage: enemy i is x[i], y[i], ... The chase loop only
+    // streams through the first block, so those stay dense and SIMD friendly.
+    struct Store {
+        // hot (chase kernel)
+        std::vector<float> x, y;
+        std::vector<float> vx, vy;
+        std::vector<float> speed;
+        std::vector<float> wobblePhase;
+
+        // cold
+        std::vector<float> radius;
+        std::vector<Type> type;
+        std::vector<float> r, g, b;
+        std::vector<int> shootCD, touchCD;
+
+        // position after the previous tick (render interpolation only)
+        std::vector<float> prevX, prevY;
+
+        size_t size() const { return x.size(); }
+        bool empty() const { return x.empty(); }
+
+        void reserve(int n) {
+            x.reserve(n); y.reserve(n); vx.reserve(n); vy.reserve(n); speed.reserve(n); wobblePhase.reserve(n);
+            radius.reserve(n); type.reserve(n); r.reserve(n); g.reserve(n); b.reserve(n);
+            shootCD.reserve(n); touchCD.reserve(n);
+            prevX.reserve(n); prevY.reserve(n);
+        }
+
+        void clear() {
+            x.clear(); y.clear(); vx.clear(); vy.clear(); speed.clear(); wobblePhase.clear();
+            radius.clear(); type.clear(); r.clear(); g.clear(); b.clear();
+            shootCD.clear(); touchCD.clear();
+            prevX.clear(); prevY.clear();
+        }
+
+        void push_back(const Enemy &e) {
+            x.push_back(e.x); y.push_back(e.y);
+            vx.push_back(e.vx); vy.push_back(e.vy);
+            speed.push_back(e.speed);
+            wobblePhase.push_back(e.wobblePhase);
+            radius.push_back(e.radius);
+            type.push_back(e.type);
+            r.push_back(e.r); g.push_back(e.g); b.push_back(e.b);
+            shootCD.push_back(e.shootCD);
+            touchCD.push_back(e.touchCD);
+            prevX.push_back(e.x); prevY.push_back(e.y);
+        }
+
+        // AoS view of enemy i (by value)
+        Enemy at(int i) const {
+            Enemy e;
+            e.type = type[i];
+            e.x = x[i]; e.y = y[i];
+            e.vx = vx[i]; e.vy = vy[i];
+            e.speed = speed[i];
+            e.radius = radius[i];
+            e.r = r[i]; e.g = g[i]; e.b = b[i];
+            e.wobblePhase = wobblePhase[i];
+            e.shootCD = shootCD[i];
+            e.touchCD = touchCD[i];
+            return e;
+        }
+
+        // O(1) removal, the last enemy takes slot i
+        void swapRemove(int i) {
+            int last = (int)size() - 1;
+            if (i != last) {
+                x[i] = x[last]; y[i] = y[last];
+                vx[i] = vx[last]; vy[i] = vy[last];
+                speed[i] = speed[last];
+                wobblePhase[i] = wobblePhase[last];
+                radius[i] = radius[last];
+                type[i] = type[last];
+                r[i] = r[last]; g[i] = g[last]; b[i] = b[last];
+                shootCD[i] = shootCD[last];
+                touchCD[i] = touchCD[last];
+                prevX[i] = prevX[last]; prevY[i] = prevY[last];
+            }
+            x.pop_back(); y.pop_back(); vx.pop_back(); vy.pop_back();
+            speed.pop_back(); wobblePhase.pop_back();
+            radius.pop_back(); type.pop_back();
+            r.pop_back(); g.pop_back(); b.pop_back();
+            shootCD.pop_back(); touchCD.pop_back();
+            prevX.pop_back(); prevY.pop_back();
+        }
+
+        // remember where everyone is before a tick moves them
+        void savePrevious() {
+            prevX.assign(x.begin(), x.end());
+            prevY.assign(y.begin(), y.end());
+        }
+    };
+
+    Store enemies;
 
     int maxEnemies = 300;
 
+    // biggest Enemy::radius handed out by spawnOne (grid cell size depends on it)
+    static constexpr float MAX_RADIUS = 0.14f;
+
+    // neighbour lookup for separation / spawn overlap, cell = largest interaction distance
+    SpatialGrid grid;
+
     // difficulty parameters (updated by setDifficulty)
     int diffLevel = 1;
     int spawnBurst = 2;
@@ -38,11 +144,31 @@ int touchCD = 0;
     // internal spawn timer
     int spawnCountdown = 180;
 
-    void init(int seed = 0) {
-        if (seed == 0) seed = (int)std::time(nullptr);
-        std::srand(seed);
+    // spawn rolls (type, speed, colour, side, timing)
+    Rng rng;
+
+    // set by Simulation, null = everything runs on the calling thread
+    JobSystem *jobs = nullptr;
+
+    // enemies / grid slots per job chunk (chase chunks stay multiples of 4 for SSE)
+    static const int CHASE_GRAIN = 1024;
+    static const int SEPARATION_GRAIN = 256;
+
+    // below these the loop stays on the calling thread (Bench: chase is ~1.3 ns
+    // an enemy with SSE, separation 150-275 ns, a parallelFor tens of us)
+    static const int CHASE_MIN_PARALLEL = 32768;
+    static const int SEPARATION_MIN_PARALLEL = 1024;
+
+    void init(uint64_t seed) {
+        rng.seed(seed, Rng::ENEMIES);
 
         enemies.clear();
+        grid.clear();
+        grid.cellSize = 2.0f * MAX_RADIUS + 0.05f;
+
+        // full-horde capacity up front, the tick never grows these
+        enemies.reserve(maxEnemies);
+        grid.reserve(maxEnemies);
         spawnCountdown = 120;
         lastSpawnAngle = 9999.0f;
     }
@@ -75,6 +201,7 @@ int touchCD = 0;
         if ((int)enemies.size() < maxEnemies) {
             spawnCountdown--;
             if (spawnCountdown <= 0) {
+                rebuildGrid();
                 for (int i = 0; i < spawnBurst && (int)enemies.size() < maxEnemies; i++) {
                     spawnOne(player, zoom, aspect);
                 }
@@ -84,95 +211,216 @@ int touchCD = 0;
         }
 
         // ---- chase ----
-        for (auto &e : enemies) {
-            e.wobblePhase += 0.05f;
+        chase(player.x, player.y);
+
+        applySeparation();
+    }
+
+    // Steer every enemy toward (px, py): normalize, lerp velocity, integrate.
+    // Enemies are independent, so chunks of them go to the job system.
+    void chase(float px, float py) {
+        const int n = (int)enemies.size();
+        JobSystem *js = JobSystem::ifAtLeast(jobs, n, CHASE_MIN_PARALLEL);
+        JobSystem::parallelFor(js, n, CHASE_GRAIN, [&](int b, int e) {
+            int done = b;
+#ifdef ENEMY_CHASE_SSE
+            done = chaseSSE(enemies, b, b + ((e - b) & ~3), px, py);
+#endif
+            chaseScalar(enemies, done, e, px, py);
+        });
+    }
+
+    // Plain loop over [begin, end). Same operations in the same order as
+    // chaseSSE, so both give bit-identical results.
+    static void chaseScalar(Store &s, int begin, int end, float px, float py) {
+        for (int i = begin; i < end; i++) {
+            s.wobblePhase[i] += 0.05f;
 
-            float dx = player.x - e.x;
-            float dy = player.y - e.y;
+            float dx = px - s.x[i];
+            float dy = py - s.y[i];
             float d = std::sqrt(dx*dx + dy*dy) + 1e-6f;
 
             float ux = dx / d;
             float uy = dy / d;
 
-            float targetVx = ux * e.speed;
-            float targetVy = uy * e.speed;
+            float targetVx = ux * s.speed[i];
+            float targetVy = uy * s.speed[i];
 
-            e.vx = lerp(e.vx, targetVx, 0.07f);
-            e.vy = lerp(e.vy, targetVy, 0.07f);
+            s.vx[i] = lerp(s.vx[i], targetVx, 0.07f);
+            s.vy[i] = lerp(s.vy[i], targetVy, 0.07f);
 
-            e.x += e.vx;
-            e.y += e.vy;
+            s.x[i] += s.vx[i];
+            s.y[i] += s.vy[i];
         }
+    }
 
-        applySeparation();
+#ifdef ENEMY_CHASE_SSE
+    // 4 enemies per step, returns where it stopped. end - begin must be a multiple of 4.
+    static int chaseSSE(Store &s, int begin, int end, float px, float py) {
+        const __m128 vpx = _mm_set1_ps(px);
+        const __m128 vpy = _mm_set1_ps(py);
+        const __m128 eps = _mm_set1_ps(1e-6f);
+        const __m128 k   = _mm_set1_ps(0.07f);
+        const __m128 wob = _mm_set1_ps(0.05f);
+
+        float *X = s.x.data(), *Y = s.y.data();
+        float *VX = s.vx.data(), *VY = s.vy.data();
+        const float *SP = s.speed.data();
+        float *W = s.wobblePhase.data();
+
+        for (int i = begin; i < end; i += 4) {
+            _mm_storeu_ps(W + i, _mm_add_ps(_mm_loadu_ps(W + i), wob));
+
+            __m128 x = _mm_loadu_ps(X + i);
+            __m128 y = _mm_loadu_ps(Y + i);
+
+            __m128 dx = _mm_sub_ps(vpx, x);
+            __m128 dy = _mm_sub_ps(vpy, y);
+            __m128 d  = _mm_add_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))), eps);
+
+            __m128 sp = _mm_loadu_ps(SP + i);
+            __m128 tvx = _mm_mul_ps(_mm_div_ps(dx, d), sp);
+            __m128 tvy = _mm_mul_ps(_mm_div_ps(dy, d), sp);
+
+            __m128 vx = _mm_loadu_ps(VX + i);
+            __m128 vy = _mm_loadu_ps(VY + i);
+            vx = _mm_add_ps(vx, _mm_mul_ps(_mm_sub_ps(tvx, vx), k));
+            vy = _mm_add_ps(vy, _mm_mul_ps(_mm_sub_ps(tvy, vy), k));
+
+            _mm_storeu_ps(VX + i, vx);
+            _mm_storeu_ps(VY + i, vy);
+            _mm_storeu_ps(X + i, _mm_add_ps(x, vx));
+            _mm_storeu_ps(Y + i, _mm_add_ps(y, vy));
+        }
+        return end;
+    }
+#endif
+
+    // Index current positions in grid (also used by Collision as its broadphase).
+    void rebuildGrid() {
+        grid.build((int)enemies.size(), [this](int i, float &x, float &y, float &r) {
+            x = enemies.x[i];
+            y = enemies.y[i];
+            r = enemies.radius[i];
+        });
     }
 
-    void draw() const {
-        for (const auto& e : enemies) {
-            glPushMatrix();
-            glTranslatef(e.x, e.y, 0.0f);
+    // farthest any monster mesh reaches from its centre, wobble included
+    static constexpr float DRAW_REACH = 0.20f;
 
-            float wob = 0.03f * std::sin(e.wobblePhase);
-            glTranslatef(0.0f, wob, 0.0f);
+    // alpha blends from the previous tick's position (0) to the current one (1)
+    int draw(RenderBatch &batch, float alpha = 1.0f, const ViewRect &view = ViewRect::everything()) const {
+        return draw(enemies, batch, alpha, view);
+    }
 
-            glColor3f(e.r, e.g, e.b);
+    // the render snapshot keeps a copy of the Store and draws that;
+    // returns how many enemies were on screen (the rest are culled)
+    static int draw(const Store &enemies, RenderBatch &batch, float alpha = 1.0f,
+                    const ViewRect &view = ViewRect::everything()) {
+        batch.reset();
+        int drawn = emit(enemies, batch, alpha, view);
+        batch.flush();
+        return drawn;
+    }
 
-            switch (e.type) {
-                case MONSTER_A: drawMonsterA(e); break;
-                case MONSTER_B: drawMonsterB(e); break;
-                case MONSTER_C: drawMonsterC(e); break;
-            }
+    // Geometry only (Bench times this without a GL context). Every enemy is a
+    // copy of its type's cached mesh, so the cost per enemy no longer includes
+    // the circle / triangle building, only one pass over the mesh's vertices.
+    //
+    // Stamping on the CPU is deliberate: the meshes are small (LOD keeps them
+    // smaller still when zoomed out), so one pass over their vertices is
+    // cheaper than a draw call. A display list per enemy (what Player does,
+    // once) measured 16 us per call on Mesa llvmpipe against ~11 us for the
+    // whole stamped enemy plus its share of the single flush, and a 10k horde
+    // would mean 30-40k calls a frame (one per colour run).
+    static int emit(const Store &enemies, RenderBatch &batch, float alpha = 1.0f,
+                    const ViewRect &view = ViewRect::everything()) {
+        const RenderBatch::Mesh *meshes = monsterMeshes();
+
+        int drawn = 0;
+        for (int i = 0; i < (int)enemies.size(); i++) {
+            float x = lerp(enemies.prevX[i], enemies.x[i], alpha);
+            float y = lerp(enemies.prevY[i], enemies.y[i], alpha);
+            if (!view.visible(x, y, DRAW_REACH)) continue;
+            drawn++;
+
+            float wob = 0.03f * std::sin(enemies.wobblePhase[i]);
 
-            glPopMatrix();
+            batch.stamp(meshes[enemies.type[i]], x, y + wob,
+                        enemies.r[i], enemies.g[i], enemies.b[i]);
         }
+        return drawn;
     }
 
 private:
+    // Bench.cpp times spawnOne / overlapsAny / applySeparation on their own
+    friend class Bench;
+
     float lastSpawnAngle = 9999.0f;
 
-    static void drawMonsterA(const Enemy& e) {
-        Shapes::Circle(0.10f, 40);
+    // one mesh per Type and Shapes LOD level, each built on first use at the
+    // level's zoom (tint = the enemy's own colour)
+    static const RenderBatch::Mesh *monsterMeshes() {
+        static std::vector<RenderBatch::Mesh> levels[Shapes::LOD_LEVELS + 1];
+
+        const int level = Shapes::lodLevel();
+        std::vector<RenderBatch::Mesh> &m = levels[level];
+        if (m.empty()) {
+            Shapes::LodScope lod(Shapes::lodLevelPixels(level));
+            RenderBatch b;
+            b.beginMesh(); buildMonsterA(b); m.push_back(b.endMesh());
+            b.beginMesh(); buildMonsterB(b); m.push_back(b.endMesh());
+            b.beginMesh(); buildMonsterC(b); m.push_back(b.endMesh());
+        }
+        return m.data();
+    }
+
+    static void buildMonsterA(RenderBatch &b) {
+        b.tint(1.0f);
+        Shapes::Circle(b, 0.10f, 40);
 
-        glColor3f(0.95f, 0.95f, 0.95f);
-        glPushMatrix(); glTranslatef(0.02f, 0.02f, 0); Shapes::Circle(0.03f, 30); glPopMatrix();
+        b.color(0.95f, 0.95f, 0.95f);
+        b.push(); b.translate(0.02f, 0.02f); Shapes::Circle(b, 0.03f, 30); b.pop();
 
-        glColor3f(0, 0, 0);
-        glPushMatrix(); glTranslatef(0.03f, 0.02f, 0); Shapes::Circle(0.012f, 20); glPopMatrix();
+        b.color(0, 0, 0);
+        b.push(); b.translate(0.03f, 0.02f); Shapes::Circle(b, 0.012f, 20); b.pop();
 
-        glColor3f(e.r * 0.8f, e.g * 0.8f, e.b * 0.8f);
+        b.tint(0.8f);
         for (int i = 0; i < 4; i++) {
-            glPushMatrix();
-            glRotatef(i * 90.0f, 0, 0, 1);
-            glTranslatef(0.0f, 0.10f, 0.0f);
-            Shapes::Triangle(0.03f);
-            glPopMatrix();
+            b.push();
+            b.rotate(i * 90.0f);
+            b.translate(0.0f, 0.10f);
+            Shapes::Triangle(b, 0.03f);
+            b.pop();
         }
     }
 
-    static void drawMonsterB(const Enemy& e) {
-        Shapes::Triangle(0.12f);
+    static void buildMonsterB(RenderBatch &b) {
+        b.tint(1.0f);
+        Shapes::Triangle(b, 0.12f);
 
-        glColor3f(1, 1, 1);
-        glPushMatrix(); glTranslatef(0.0f, -0.03f, 0.0f); Shapes::Rectangle(0.10f, 0.03f); glPopMatrix();
+        b.color(1, 1, 1);
+        b.push(); b.translate(0.0f, -0.03f); Shapes::Rectangle(b, 0.10f, 0.03f); b.pop();
 
-        glColor3f(e.r * 0.7f, e.g * 0.7f, e.b * 0.7f);
-        glPushMatrix(); glTranslatef(-0.10f, -0.02f, 0); glRotatef(20, 0, 0, 1); Shapes::Triangle(0.05f); glPopMatrix();
-        glPushMatrix(); glTranslatef( 0.10f, -0.02f, 0); glRotatef(-20,0, 0, 1); Shapes::Triangle(0.05f); glPopMatrix();
+        b.tint(0.7f);
+        b.push(); b.translate(-0.10f, -0.02f); b.rotate(20);  Shapes::Triangle(b, 0.05f); b.pop();
+        b.push(); b.translate( 0.10f, -0.02f); b.rotate(-20); Shapes::Triangle(b, 0.05f); b.pop();
     }
 
-    static void drawMonsterC(const Enemy& e) {
-        Shapes::HalfCircle(0.12f, 40);
+    static void buildMonsterC(RenderBatch &b) {
+        b.tint(1.0f);
+        Shapes::HalfCircle(b, 0.12f, 40);
 
-        glColor3f(e.r * 0.8f, e.g * 0.8f, e.b * 0.8f);
+        b.tint(0.8f);
         for (int i = 0; i < 4; i++) {
             float x = -0.06f + i * 0.04f;
-            glPushMatrix(); glTranslatef(x, -0.10f, 0.0f); Shapes::Rectangle(0.015f, 0.08f); glPopMatrix();
-            glPushMatrix(); glTranslatef(x, -0.15f, 0.0f); Shapes::Circle(0.012f, 16); glPopMatrix();
+            b.push(); b.translate(x, -0.10f); Shapes::Rectangle(b, 0.015f, 0.08f); b.pop();
+            b.push(); b.translate(x, -0.15f); Shapes::Circle(b, 0.012f, 16); b.pop();
         }
 
-        glColor3f(0, 0, 0);
-        glPushMatrix(); glTranslatef(-0.03f, 0.03f, 0); Shapes::Circle(0.01f, 14); glPopMatrix();
-        glPushMatrix(); glTranslatef( 0.03f, 0.03f, 0); Shapes::Circle(0.01f, 14); glPopMatrix();
+        b.color(0, 0, 0);
+        b.push(); b.translate(-0.03f, 0.03f); Shapes::Circle(b, 0.01f, 14); b.pop();
+        b.push(); b.translate( 0.03f, 0.03f); Shapes::Circle(b, 0.01f, 14); b.pop();
     }
 
     void spawnOne(const Player& player, float zoom, float aspect) {
@@ -181,7 +429,7 @@ private:
         float margin = 0.40f;
 
         Enemy e;
-        e.type = (Type)(std::rand() % 3);
+        e.type = (Type)rng.below(3);
         e.vx = e.vy = 0.0f;
         e.wobblePhase = randRange(0.0f, 6.28f);
 
@@ -193,7 +441,7 @@ private:
         e.speed *= speedMul;
 
         for (int tries = 0; tries < 30; tries++) {
-            int side = std::rand() % 4;
+            int side = rng.below(4);
             float x = player.x, y = player.y;
 
             if (side == 0) { x = player.x - (halfW + margin); y = player.y + randRange(-halfH, halfH); }
@@ -218,52 +466,70 @@ private:
     }
 
     bool overlapsAny(const Enemy& e) const {
-        for (const auto& o : enemies) {
-            float dx = e.x - o.x;
-            float dy = e.y - o.y;
+        auto hits = [&](int, float ox, float oy, float orad) {
+            float dx = e.x - ox;
+            float dy = e.y - oy;
             float d2 = dx*dx + dy*dy;
-            float rr = (e.radius + o.radius + 0.05f);
-            if (d2 < rr*rr) return true;
+            float rr = (e.radius + orad + 0.05f);
+            return d2 < rr*rr;
+        };
+
+        if (grid.queryRadius(e.x, e.y, e.radius + MAX_RADIUS + 0.05f, hits)) return true;
+
+        // spawned after the grid was built
+        for (int i = grid.indexed; i < (int)enemies.size(); i++) {
+            if (hits(i, enemies.x[i], enemies.y[i], enemies.radius[i])) return true;
         }
         return false;
     }
 
+    // Every overlapping pair pushes both enemies apart by 20% of the overlap.
+    // Each slot gathers its own push from every neighbour, reading the grid's
+    // copy of the start-of-pass positions and writing only its own enemy, so
+    // chunks of slots can run on any thread and the sum is always taken in the
+    // same order. That does each pair's maths twice, which buys the threading.
     void applySeparation() {
-        for (int i = 0; i < (int)enemies.size(); i++) {
-            for (int j = i + 1; j < (int)enemies.size(); j++) {
-                auto &a = enemies[i];
-                auto &b = enemies[j];
-
-                float dx = a.x - b.x;
-                float dy = a.y - b.y;
-                float d = std::sqrt(dx*dx + dy*dy) + 1e-6f;
-                float minD = a.radius + b.radius + 0.02f;
-
-                if (d < minD) {
-                    float ux = dx / d;
-                    float uy = dy / d;
-                    float push = (minD - d) * 0.20f;
-
-                    a.x += ux * push;
-                    a.y += uy * push;
-                    b.x -= ux * push;
-                    b.y -= uy * push;
+        rebuildGrid();
+
+        JobSystem *js = JobSystem::ifAtLeast(jobs, grid.indexed, SEPARATION_MIN_PARALLEL);
+        JobSystem::parallelFor(js, grid.indexed, SEPARATION_GRAIN, [&](int begin, int end) {
+            grid.forEachNeighbourhood(begin, end, [&](int k, const SpatialGrid::Range *nb, int nNb) {
+                float ax = grid.x(k), ay = grid.y(k), ar = grid.r(k);
+                float px = 0.0f, py = 0.0f;
+
+                // Branch-free on purpose, in a crowd about half the candidates
+                // overlap and an if() mispredicts. k against itself adds 0.
+                for (int c = 0; c < nNb; c++) {
+                    for (int m = nb[c].begin; m < nb[c].end; m++) {
+                        float dx = ax - grid.x(m);
+                        float dy = ay - grid.y(m);
+                        float d = std::sqrt(dx*dx + dy*dy) + 1e-6f;
+                        float minD = ar + grid.r(m) + 0.02f;
+
+                        float push = std::max(minD - d, 0.0f) * 0.20f / d;
+                        px += dx * push;
+                        py += dy * push;
+                    }
                 }
-            }
-        }
+
+                int i = grid.item(k);
+                enemies.x[i] += px;
+                enemies.y[i] += py;
+            });
+        });
     }
 
-    static void setColor(Enemy& e, int kind) {
+    void setColor(Enemy& e, int kind) {
         if (kind == 0) { e.r = randRange(0.3f, 0.9f); e.g = randRange(0.2f, 0.6f); e.b = randRange(0.6f, 1.0f); }
         if (kind == 1) { e.r = randRange(0.6f, 1.0f); e.g = randRange(0.2f, 0.8f); e.b = randRange(0.2f, 0.6f); }
         if (kind == 2) { e.r = randRange(0.2f, 0.6f); e.g = randRange(0.7f, 1.0f); e.b = randRange(0.2f, 0.8f); }
     }
 
-    static float randRange(float a, float b) {
-        return a + (b - a) * (float(std::rand()) / float(RAND_MAX));
+    float randRange(float a, float b) {
+        return rng.range(a, b);
     }
-    static int randRangeInt(int a, int b) {
-        return a + (std::rand() % (b - a + 1));
+    int randRangeInt(int a, int b) {
+        return rng.rangeInt(a, b);
     }
     static float lerp(float a, float b, float t) {
         return a + (b - a) * t;
@@ -0,0 +1,46 @@
+#include <algorithm>
+
+// Accumulator for a fixed-rate simulation under a variable-rate render loop.
+// Every gameplay speed, cooldown and timer is "per tick", so the simulation has
+// to run at one rate no matter how fast frames come in. Feed it the wall time
+// of each frame, run the ticks it hands back, then draw with alpha() to blend
+// between the last two ticks.
+class FixedStep {
+public:
+    // gameplay was tuned against a 16 ms timer, i.e. ~60 ticks/s
+    double tickHz = 60.0;
+
+    // after a long stall (window drag, breakpoint) drop the backlog instead of
+    // running hundreds of catch-up ticks in one frame
+    int maxTicksPerFrame = 5;
+
+    explicit FixedStep(double hz = 60.0) : tickHz(hz) {}
+
+    double tickSeconds() const { return 1.0 / tickHz; }
+
+    // add dt seconds of wall time, returns how many ticks to run now
+    int advance(double dt) {
+        if (dt < 0.0) dt = 0.0;
+        acc += dt;
+
+        const double step = tickSeconds();
+        int n = (int)(acc / step);
+        if (n > maxTicksPerFrame) {
+            n = maxTicksPerFrame;
+            acc = 0.0;
+        } else {
+            acc -= n * step;
+        }
+        return n;
+    }
+
+    // 0..1: how far wall time is past the last tick, towards the next one
+    float alpha() const {
+        return (float)std::min(1.0, acc / tickSeconds());
+    }
+
+    void reset() { acc = 0.0; }
+
+private:
+    double acc = 0.0;
+};
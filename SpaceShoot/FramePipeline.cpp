@@ -0,0 +1,160 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// NOTE: expects Simulation.cpp to be included before this file.
+// Lets the simulation and the drawing of a frame overlap. The sim thread runs
+// the frame's ticks and copies everything the draw code reads into a
+// RenderSnapshot; the main thread (which owns the GL context) meanwhile draws
+// the snapshot published by the previous frame. A frame then costs about
+// max(sim, render) instead of sim + render, for one frame of extra latency.
+//
+// Input callbacks, menus and audio still touch the live GameWorld directly:
+// main.cpp waits for the sim thread before it returns to GLUT, so they never
+// run while a tick is in flight.
+
+// Everything display() needs from the world, copied at the end of a batch of
+// ticks. The vectors keep their capacity between captures, so copying into a
+// recycled snapshot does not allocate once the horde has peaked.
+struct RenderSnapshot {
+    bool playing = false;
+
+    Player player;
+    float rotX = 0.0f, rotY = 0.0f;
+    float zoom = 2.0f, prevZoom = 2.0f;
+
+    Background bg;
+    EnemySystem::Store enemies;
+    EnemyCombat enemyCombat;
+    Effects fx;
+    Shooting shooting;
+    Scoreboard hud;
+
+    void capture(const GameWorld &w, bool isPlaying) {
+        playing = isPlaying;
+
+        player = w.player;
+        rotX = w.movement.rotX;
+        rotY = w.movement.rotY;
+        zoom = w.zoom;
+        prevZoom = w.prevZoom;
+
+        bg = w.bg;
+        enemies = w.enemies.enemies;
+        enemyCombat = w.enemyCombat;
+        fx = w.fx;
+        shooting = w.shooting;
+        hud = w.hud;
+    }
+};
+
+// Single producer / single consumer, never blocks either side. The producer
+// fills back() and publish()es it; latest() hands the consumer the newest
+// published slot and keeps returning it until a newer one arrives.
+template <class T>
+class TripleBuffer {
+public:
+    T &back() { return slots[writing]; }
+
+    void publish() {
+        writing = middle.exchange(writing | FRESH) & INDEX;
+    }
+
+    const T &latest() {
+        if (middle.load() & FRESH) reading = middle.exchange(reading) & INDEX;
+        return slots[reading];
+    }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;   // middle holds something the reader has not seen
+
+    T slots[3];
+    int writing = 0;              // producer only
+    int reading = 1;              // consumer only
+    std::atomic<int> middle{2};
+};
+
+// One thread that runs batches of ticks on request. kick() hands it a batch,
+// wait() blocks until that batch and its snapshot are done.
+class SimThread {
+public:
+    SimThread() {}
+    SimThread(const SimThread &) = delete;
+    SimThread &operator=(const SimThread &) = delete;
+    ~SimThread() { stop(); }
+
+    void start(GameWorld *w, TripleBuffer<RenderSnapshot> *out) {
+        stop();
+        world = w;
+        snaps = out;
+        quit = false;
+        thread = std::thread([this] { loop(); });
+    }
+
+    void stop() {
+        if (!thread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lk(m);
+            quit = true;
+        }
+        cv.notify_all();
+        thread.join();
+    }
+
+    void kick(int ticks, bool playing) {
+        {
+            std::lock_guard<std::mutex> lk(m);
+            batchTicks = ticks;
+            batchPlaying = playing;
+            busy = true;
+        }
+        cv.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lk(m);
+        cv.wait(lk, [&] { return !busy; });
+    }
+
+private:
+    GameWorld *world = nullptr;
+    TripleBuffer<RenderSnapshot> *snaps = nullptr;
+
+    std::thread thread;
+    std::mutex m;
+    std::condition_variable cv;
+    bool busy = false;
+    bool quit = false;
+    int batchTicks = 0;
+    bool batchPlaying = false;
+
+    void loop() {
+        for (;;) {
+            int ticks;
+            bool playing;
+            {
+                std::unique_lock<std::mutex> lk(m);
+                cv.wait(lk, [&] { return quit || busy; });
+                if (quit) return;
+                ticks = batchTicks;
+                playing = batchPlaying;
+            }
+
+            for (int i = 0; i < ticks; i++) Simulation::tick(*world, playing);
+
+            // nothing moved, the last snapshot is still current
+            if (ticks > 0) {
+                snaps->back().capture(*world, playing);
+                snaps->publish();
+            }
+
+            {
+                std::lock_guard<std::mutex> lk(m);
+                busy = false;
+            }
+            cv.notify_all();
+        }
+    }
+};
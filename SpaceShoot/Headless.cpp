@@ -0,0 +1,318 @@
+// Headless simulation driver (separate build target, no window / no GLUT init / no audio).
+// Runs the exact same Simulation::tick as main.cpp as fast as the CPU allows, with a
+// scripted input source (or a recorded session), and reports ticks/second.
+//
+// Only the GL headers are needed to compile (draw code is never called, so nothing
+// GL ends up in the binary):
+//     g++ -std=c++17 -O2 Headless.cpp -o SpaceShootHeadless
+//
+// usage: SpaceShootHeadless [--ticks N] [--seed N] [--home] [--quiet]
+//                           [--max-enemies N] [--no-fire]
+//                           [--record file] [--replay file]
+//                           [--profile] [--profile-csv file] [--threads N]
+//                           [--arena] [--sweep N]
+//
+// --replay runs a log written by `SpaceShoot --record file` (or --record here)
+// tick for tick and checks the final state against the one recorded; exit
+// code 1 on mismatch. Same log + same build = same workload, so it doubles as
+// a performance regression run.
+//
+// --profile times every simulation stage (one row per tick with --profile-csv)
+// and prints min / avg / p99 per stage over the last Profiler::WINDOW ticks.
+//
+// --threads N runs the heavy stages on N threads (default 1). The checksum must
+// not change with N.
+//
+// --sweep N runs the same session (script or --replay) on a fresh world at
+// 1, 2, .. N threads and prints ticks/s and the speedup over 1 thread for
+// each, plus whether every checksum agreed (exit code 1 if not).
+//
+// --arena reports the high water mark of the per-tick scratch arena and
+// whether it ever had to fall back to the heap.
+
+#include <GL/glut.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <algorithm>
+
+#include "Rng.cpp"
+#include "Text.cpp"
+#include "Profiler.cpp"
+#include "Pool.cpp"
+#include "Arena.cpp"
+#include "JobSystem.cpp"
+#include "Movers.cpp"
+#include "Shapes.cpp"
+#include "ViewRect.cpp"
+#include "Player.cpp"
+#include "Movement.cpp"
+#include "PlayerMove.cpp"
+#include "Background.cpp"
+#include "EnemySystem.cpp"
+#include "Scoreboard.cpp"
+#include "Shooting.cpp"
+#include "Effects.cpp"
+#include "Collision.cpp"
+#include "EnemyCombat.cpp"
+#include "Simulation.cpp"
+#include "InputLog.cpp"
+
+// Every heap allocation in the process bumps this, so the run can show the tick
+// loop itself does not touch the heap once pools and scratch buffers are warm.
+static long gHeapAllocs = 0;
+
+void *operator new(std::size_t n) {
+    gHeapAllocs++;
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+// Deterministic stand-in for a player: keeps the trigger held, strafes around
+// in a square, jumps now and then and slowly zooms in and out. Works through
+// InputEvents like the real Input, so a scripted run can be recorded too.
+class ScriptedInput {
+public:
+    bool fire = true;
+    InputLog *log = nullptr;
+
+    void apply(GameWorld &w, long tick) {
+        // trigger held (turn off to let the horde build up)
+        key(w, 'r', fire);
+
+        // strafe: w -> d -> s -> a, 90 ticks each
+        static const unsigned char dirs[4] = { 'w', 'd', 's', 'a' };
+        int leg = (int)((tick / 90) % 4);
+        for (int i = 0; i < 4; i++) key(w, dirs[i], i == leg);
+
+        // jump every 5 seconds
+        key(w, ' ', tick % 300 == 0);
+
+        // zoom out for a while, then back in (spawn ring depends on zoom)
+        long z = tick % 1200;
+        key(w, 'i', z >= 0   && z < 60);
+        key(w, 'u', z >= 600 && z < 660);
+    }
+
+private:
+    bool held[256] = {};
+
+    // only changes become events, like a real keyboard
+    void key(GameWorld &w, unsigned char k, bool down) {
+        if (held[k] == down) return;
+        held[k] = down;
+
+        InputEvent e = InputEvent::make(down ? InputEvent::KEY_DOWN : InputEvent::KEY_UP, k);
+        if (log) log->write(w.tick, e);
+        e.apply(w.player, w.movement, w.shooting);
+    }
+};
+
+// --sweep: one timed run of the whole session on a fresh world (no recording,
+// profiling or progress lines). Returns ticks/s.
+static double sweepRun(int threads, long ticks, uint64_t seed, bool playing, bool fire,
+                       int maxEnemies, const InputLog *replay, uint64_t &checksum) {
+    std::unique_ptr<GameWorld> world(new GameWorld());
+    if (maxEnemies > 0) world->enemies.maxEnemies = maxEnemies;
+
+    Simulation::init(*world, seed);
+    world->jobs.start(threads);
+    if (playing && !replay) Simulation::resetForPlay(*world, world->seed);
+
+    ScriptedInput script;
+    script.fire = fire;
+    InputLog log;
+    if (replay) log = *replay;   // own read position
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (long t = 0; t < ticks; t++) {
+        if (replay) log.applyDue(*world, playing);
+        else script.apply(*world, t);
+        Simulation::tick(*world, playing);
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    checksum = Simulation::checksum(*world);
+    return ticks / std::max(wall, 1e-9);
+}
+
+int main(int argc, char *argv[]) {
+    long ticks = 60L * 60L * 10L;   // 10 simulated minutes
+    uint64_t seed = 1;
+    bool playing = true;
+    bool quiet = false;
+    bool fire = true;
+    int maxEnemies = 0;
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+    const char *csvPath = nullptr;
+    bool profile = false;
+    int threads = 1;
+    bool arenaReport = false;
+    int sweep = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--ticks") && i + 1 < argc) ticks = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc) seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--home")) playing = false;
+        else if (!std::strcmp(argv[i], "--quiet")) quiet = true;
+        else if (!std::strcmp(argv[i], "--no-fire")) fire = false;
+        else if (!std::strcmp(argv[i], "--max-enemies") && i + 1 < argc) maxEnemies = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--record") && i + 1 < argc) recordPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--replay") && i + 1 < argc) replayPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--profile")) profile = true;
+        else if (!std::strcmp(argv[i], "--profile-csv") && i + 1 < argc) { csvPath = argv[++i]; profile = true; }
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--arena")) arenaReport = true;
+        else if (!std::strcmp(argv[i], "--sweep") && i + 1 < argc) sweep = std::atoi(argv[++i]);
+        else {
+            std::fprintf(stderr, "usage: %s [--ticks N] [--seed N] [--home] [--quiet] "
+                                 "[--max-enemies N] [--no-fire] [--record file] [--replay file]\n"
+                                 "       [--profile] [--profile-csv file] [--threads N] [--arena] [--sweep N]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    static GameWorld world;   // big-ish, keep it off the stack
+    ScriptedInput script;
+    script.fire = fire;
+
+    InputLog replay, recorder;
+    if (replayPath) {
+        if (!replay.load(replayPath)) {
+            std::fprintf(stderr, "cannot read input log %s\n", replayPath);
+            return 2;
+        }
+        seed = replay.seed;
+        playing = false;            // until the log's START
+        ticks = replay.endTick();   // the whole session, --ticks is ignored
+    }
+    if (ticks < 1) ticks = 1;
+
+    if (sweep > 0) {
+        std::printf("%7s %12s %8s   (%ld ticks, seed %llu)\n", "threads", "ticks/s", "speedup",
+                    ticks, (unsigned long long)seed);
+        double base = 0.0;
+        uint64_t first = 0;
+        bool agree = true;
+        for (int n = 1; n <= sweep; n++) {
+            uint64_t sum;
+            double rate = sweepRun(n, ticks, seed, playing, fire, maxEnemies,
+                                   replayPath ? &replay : nullptr, sum);
+            if (n == 1) { base = rate; first = sum; }
+            agree = agree && sum == first;
+            std::printf("%7d %12.0f %7.2fx\n", n, rate, rate / base);
+        }
+        std::printf("checksum %016llx %s\n", (unsigned long long)first,
+                    agree ? "at every thread count" : "DIFFERS between thread counts");
+        return agree ? 0 : 1;
+    }
+
+    if (maxEnemies > 0) world.enemies.maxEnemies = maxEnemies;
+
+    Simulation::init(world, seed);
+    world.jobs.start(threads);
+
+    if (recordPath) {
+        if (!recorder.openWrite(recordPath, world.seed)) {
+            std::fprintf(stderr, "cannot write input log %s\n", recordPath);
+            return 2;
+        }
+        script.log = &recorder;
+    }
+    if (csvPath && !world.prof.openCsv(csvPath)) {
+        std::fprintf(stderr, "cannot write %s\n", csvPath);
+        return 2;
+    }
+    world.prof.enabled = profile;
+
+    if (playing && !replayPath) {
+        Simulation::resetForPlay(world, world.seed);
+        recorder.write(world.tick, InputEvent::make(InputEvent::START, 0, 0, world.seed));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto tReport = t0;
+
+    // vectors grow to their working size during the first seconds
+    const long warmTicks = std::min(ticks, 600L);
+    long allocsAtStart = gHeapAllocs, allocsWarm = 0;
+
+    for (long t = 0; t < ticks; t++) {
+        if (replayPath) replay.applyDue(world, playing);
+        else script.apply(world, t);
+        Simulation::tick(world, playing);
+
+        // one tick = one profiler frame here
+        world.prof.addTicks(1);
+        world.prof.endFrame();
+
+        if (t + 1 == warmTicks) allocsWarm = gHeapAllocs;
+
+        if (!quiet && (t + 1) % 3600 == 0) {
+            auto now = std::chrono::steady_clock::now();
+            double dt = std::chrono::duration<double>(now - tReport).count();
+            tReport = now;
+            std::printf("[%6ld s] enemies %4d  bullets %3d  ebullets %4d  score %6d  level %3d  hp %3d  | %.0f ticks/s\n",
+                        (t + 1) / 60,
+                        (int)world.enemies.enemies.size(),
+                        (int)world.shooting.bullets.size(),
+                        (int)world.enemyCombat.bullets.size(),
+                        world.hud.score, world.hud.level, world.player.hp,
+                        3600.0 / std::max(dt, 1e-9));
+        }
+    }
+
+    long steadyAllocs = gHeapAllocs - allocsWarm;   // before stdio allocates its buffer
+
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    wall = std::max(wall, 1e-9);
+
+    std::printf("ticks %ld  wall %.3f s  %.0f ticks/s  (%.1f sim-min per wall-min)\n",
+                ticks, wall, ticks / wall, (ticks / 60.0) / wall);
+    std::printf("heap allocations: %ld in the first %ld ticks, %ld in the other %ld (%.3f per tick)\n",
+                allocsWarm - allocsAtStart, warmTicks, steadyAllocs, ticks - warmTicks,
+                (double)steadyAllocs / (double)std::max(1L, ticks - warmTicks));
+    std::printf("seed %llu  checksum %016llx\n", (unsigned long long)world.seed,
+                (unsigned long long)Simulation::checksum(world));
+    std::printf("final: score %d  level %d  enemies %d  hp %d\n",
+                world.hud.score, world.hud.level,
+                (int)world.enemies.enemies.size(), world.player.hp);
+    recorder.finish(world);
+
+    if (arenaReport) {
+        const Arena &a = world.scratch;
+        std::printf("tick arena: high water %d KB of a %d KB block, %ld heap fallbacks, %ld regrows\n",
+                    a.highWaterKB(), a.capacityKB(), a.heapFallbacks(), a.regrows());
+    }
+
+    if (profile) {
+        std::printf("%-13s %9s %9s %9s   (ms, last %d ticks)\n", "stage", "min", "avg", "p99", Profiler::WINDOW);
+        for (int st = 0; st < Profiler::AUDIO; st++) {
+            Profiler::Stats ps = world.prof.stats(st);
+            std::printf("%-13s %9.4f %9.4f %9.4f\n", Profiler::name(st), ps.minMs, ps.avgMs, ps.p99Ms);
+        }
+        world.prof.closeCsv();
+    }
+
+    if (replayPath) {
+        uint64_t want;
+        if (!replay.expectedChecksum(want)) {
+            std::printf("replay: %d events, log has no END (session cut short), nothing to check\n",
+                        (int)replay.events.size());
+        } else if (want == Simulation::checksum(world)) {
+            std::printf("replay: %d events, final state MATCHES the recording\n", (int)replay.events.size());
+        } else {
+            std::printf("replay: %d events, final state DIFFERS from the recording (%016llx)\n",
+                        (int)replay.events.size(), (unsigned long long)want);
+            return 1;
+        }
+    }
+    return 0;
+}
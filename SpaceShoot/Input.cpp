@@ -18,6 +18,7 @@ extern MenuUI menuUI;
 
 // from main.cpp
 extern void startPlaying();
+extern void toggleProfiler();
 extern int  gPlayerColorIndex;
 
 class Input {
@@ -35,6 +36,10 @@ public:
     static float* pTargetZoom;
     static float  fovyDeg;
 
+    // optional session recording, events are stamped with *pTick
+    static InputLog*   log;
+    static const long* pTick;
+
     static void init(Player* _p, Movement* _mv, Shooting* _sh,
                      int* _w, int* _h, float* _aspect,
                      float* _zoom, float* _tzoom,
@@ -46,6 +51,11 @@ public:
         fovyDeg = _fovyDeg;
     }
 
+    static void setRecorder(InputLog* _log, const long* _tick) {
+        log = _log;
+        pTick = _tick;
+    }
+
     static void installCallbacks() {
         glutKeyboardFunc(onKeyDown);
         glutKeyboardUpFunc(onKeyUp);
@@ -95,44 +105,33 @@ private:
         // if UI panel open, block movement/shoot keys
         if (uiPanelOpenBlockingGameInput()) return;
 
-        // movement keys should work in HOME + PLAYING
-        if (mv && p) mv->onKeyDown(key, *p);
-
-        // shooting key (R)
-        if (sh) {
-            if (key == 'r' || key == 'R') sh->fireKeyR = true;
-        }
+        // movement keys should work in HOME + PLAYING, R shoots
+        feed(InputEvent::make(InputEvent::KEY_DOWN, key));
     }
 
     static void onKeyUp(unsigned char key, int, int) {
         if (uiPanelOpenBlockingGameInput()) return;
 
-        if (mv) mv->onKeyUp(key);
-
-        if (sh) {
-            if (key == 'r' || key == 'R') sh->fireKeyR = false;
-        }
+        feed(InputEvent::make(InputEvent::KEY_UP, key));
     }
 
+    // arrow keys behave like WASD
     static void onSpecialDown(int key, int, int) {
+        // F3: stage timings overlay (not gameplay, never recorded)
+        if (key == GLUT_KEY_F3) {
+            toggleProfiler();
+            return;
+        }
+
         if (uiPanelOpenBlockingGameInput()) return;
-        if (!mv) return;
 
-        // arrow keys behave like WASD
-        if (key == GLUT_KEY_LEFT)  mv->keyDown[(unsigned char)'a'] = true;
-        if (key == GLUT_KEY_RIGHT) mv->keyDown[(unsigned char)'d'] = true;
-        if (key == GLUT_KEY_UP)    mv->keyDown[(unsigned char)'w'] = true;
-        if (key == GLUT_KEY_DOWN)  mv->keyDown[(unsigned char)'s'] = true;
+        feed(InputEvent::make(InputEvent::SPECIAL_DOWN, key));
     }
 
     static void onSpecialUp(int key, int, int) {
         if (uiPanelOpenBlockingGameInput()) return;
-        if (!mv) return;
 
-        if (key == GLUT_KEY_LEFT)  mv->keyDown[(unsigned char)'a'] = false;
-        if (key == GLUT_KEY_RIGHT) mv->keyDown[(unsigned char)'d'] = false;
-        if (key == GLUT_KEY_UP)    mv->keyDown[(unsigned char)'w'] = false;
-        if (key == GLUT_KEY_DOWN)  mv->keyDown[(unsigned char)'s'] = false;
+        feed(InputEvent::make(InputEvent::SPECIAL_UP, key));
     }
 
     static void onMouseButton(int button, int state, int x, int y) {
@@ -170,19 +169,24 @@ private:
         }
 
         // ----- SHOOTING (PLAYING) -----
-        if (gameState == PLAYING() && sh) {
-            if (button == GLUT_LEFT_BUTTON) {
-                sh->fireMouse = (state == GLUT_DOWN);
-            }
+        if (gameState == PLAYING()) {
+            feed(InputEvent::make(InputEvent::MOUSE_BUTTON, button, state));
         }
     }
 
     static void onMouseMove(int x, int y) {
         mouseSX = x;
         mouseSY = y;
+        feed(InputEvent::make(InputEvent::MOUSE_MOVE, x, y));
         // forcing redraw makes hover + aim feel instant
         glutPostRedisplay();
     }
+
+    // gameplay side of an event: log it (if recording), then apply it
+    static void feed(const InputEvent &e) {
+        if (log) log->write(*pTick, e);
+        if (p && mv && sh) e.apply(*p, *mv, *sh);
+    }
 };
 
 // ===== static storage =====
@@ -199,3 +203,6 @@ float* Input::pAspect = nullptr;
 float* Input::pZoom = nullptr;
 float* Input::pTargetZoom = nullptr;
 float  Input::fovyDeg = 60.0f;
+
+InputLog*   Input::log = nullptr;
+const long* Input::pTick = nullptr;
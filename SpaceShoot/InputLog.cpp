@@ -0,0 +1,266 @@
+#include <GL/glut.h>
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+// NOTE: expects Simulation.cpp to be included before this file.
+// Record / replay of everything that reaches the simulation from outside:
+// key and mouse events (after the menu has had its say), window resizes (enemies
+// spawn just outside the view, so its aspect is gameplay) and the start of a run.
+// Each event is stamped with GameWorld::tick, the number of ticks already run
+// when it arrived, and is applied right before that tick on replay. With the
+// seed in the header that reproduces a session bit for bit, at any frame rate.
+//
+// File layout (little endian):
+//     "SSIL" u8 version  u64 seed
+//     then per event: varint ticks-since-previous-event, u8 kind, payload
+//         KEY_* / SPECIAL_*   u8 key
+//         MOUSE_BUTTON        u8 button, u8 state
+//         MOUSE_MOVE          i16 x, i16 y (window pixels)
+//         RESIZE              u16 width, u16 height (window pixels)
+//         START               u64 seed of the run
+//         END                 u64 Simulation::checksum at the last tick
+
+struct InputEvent {
+    enum Kind : uint8_t {
+        KEY_DOWN = 1, KEY_UP, SPECIAL_DOWN, SPECIAL_UP,
+        MOUSE_BUTTON, MOUSE_MOVE,
+        START, END,
+        RESIZE
+    };
+
+    uint8_t kind = 0;
+    int a = 0, b = 0;      // key / button+state / mouse x+y / window w+h
+    uint64_t value = 0;    // START seed, END checksum
+
+    static InputEvent make(Kind k, int a = 0, int b = 0, uint64_t v = 0) {
+        InputEvent e;
+        e.kind = k; e.a = a; e.b = b; e.value = v;
+        return e;
+    }
+
+    // What one event does to the gameplay state. Input (live) and the replayer
+    // both go through here, so they cannot drift apart.
+    // START, END and RESIZE are handled by whoever owns the GameWorld.
+    void apply(Player &p, Movement &mv, Shooting &sh) const {
+        switch (kind) {
+            case KEY_DOWN:
+                mv.onKeyDown((unsigned char)a, p);
+                if (a == 'r' || a == 'R') sh.fireKeyR = true;
+                break;
+
+            case KEY_UP:
+                mv.onKeyUp((unsigned char)a);
+                if (a == 'r' || a == 'R') sh.fireKeyR = false;
+                break;
+
+            // arrow keys behave like WASD
+            case SPECIAL_DOWN:
+            case SPECIAL_UP: {
+                bool down = (kind == SPECIAL_DOWN);
+                if (a == GLUT_KEY_LEFT)  mv.keyDown[(unsigned char)'a'] = down;
+                if (a == GLUT_KEY_RIGHT) mv.keyDown[(unsigned char)'d'] = down;
+                if (a == GLUT_KEY_UP)    mv.keyDown[(unsigned char)'w'] = down;
+                if (a == GLUT_KEY_DOWN)  mv.keyDown[(unsigned char)'s'] = down;
+                break;
+            }
+
+            case MOUSE_BUTTON:
+                if (a == GLUT_LEFT_BUTTON) sh.fireMouse = (b == GLUT_DOWN);
+                break;
+
+            // aim is not mouse driven (yet), logged so replays keep it once it is
+            case MOUSE_MOVE:
+            default:
+                break;
+        }
+    }
+};
+
+class InputLog {
+public:
+    struct Stamped {
+        long tick;
+        InputEvent e;
+    };
+
+    static const int VERSION = 2;   // 2: RESIZE
+
+    uint64_t seed = 0;
+    std::vector<Stamped> events;
+
+    // ---------- recording (streams straight to the file) ----------
+    bool openWrite(const char *path, uint64_t runSeed) {
+        close();
+        out = std::fopen(path, "wb");
+        if (!out) return false;
+
+        seed = runSeed;
+        lastTick = 0;
+        std::fwrite("SSIL", 1, 4, out);
+        putU8((uint8_t)VERSION);
+        putU64(seed);
+        return true;
+    }
+
+    bool recording() const { return out != nullptr; }
+
+    void write(long tick, const InputEvent &e) {
+        if (!out) return;
+
+        putVarint((uint64_t)(tick - lastTick));
+        lastTick = tick;
+        putU8(e.kind);
+
+        switch (e.kind) {
+            case InputEvent::KEY_DOWN: case InputEvent::KEY_UP:
+            case InputEvent::SPECIAL_DOWN: case InputEvent::SPECIAL_UP:
+                putU8((uint8_t)e.a);
+                break;
+            case InputEvent::MOUSE_BUTTON:
+                putU8((uint8_t)e.a);
+                putU8((uint8_t)e.b);
+                break;
+            case InputEvent::MOUSE_MOVE:
+                putU16((uint16_t)(int16_t)e.a);
+                putU16((uint16_t)(int16_t)e.b);
+                break;
+            case InputEvent::RESIZE:
+                putU16((uint16_t)e.a);
+                putU16((uint16_t)e.b);
+                break;
+            case InputEvent::START: case InputEvent::END:
+                putU64(e.value);
+                break;
+        }
+    }
+
+    // stamps END with the final state so a replay can check itself
+    void finish(const GameWorld &w) {
+        if (!out) return;
+        write(w.tick, InputEvent::make(InputEvent::END, 0, 0, Simulation::checksum(w)));
+        close();
+    }
+
+    void close() {
+        if (out) std::fclose(out);
+        out = nullptr;
+    }
+
+    // ---------- playback ----------
+    bool load(const char *path) {
+        events.clear();
+        next = 0;
+
+        std::FILE *f = std::fopen(path, "rb");
+        if (!f) return false;
+        std::vector<uint8_t> buf;
+        uint8_t chunk[4096];
+        size_t n;
+        while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) buf.insert(buf.end(), chunk, chunk + n);
+        std::fclose(f);
+
+        const uint8_t *p = buf.data();
+        const uint8_t *end = p + buf.size();
+        if (buf.size() < 13 || p[0] != 'S' || p[1] != 'S' || p[2] != 'I' || p[3] != 'L' || p[4] != VERSION) return false;
+        p += 5;
+        seed = getU64(p);
+
+        long tick = 0;
+        while (p < end) {
+            uint64_t delta;
+            if (!getVarint(p, end, delta) || p >= end) return false;
+            tick += (long)delta;
+
+            InputEvent e;
+            e.kind = *p++;
+            size_t need = 0;
+            switch (e.kind) {
+                case InputEvent::KEY_DOWN: case InputEvent::KEY_UP:
+                case InputEvent::SPECIAL_DOWN: case InputEvent::SPECIAL_UP: need = 1; break;
+                case InputEvent::MOUSE_BUTTON: need = 2; break;
+                case InputEvent::MOUSE_MOVE:   need = 4; break;
+                case InputEvent::RESIZE:       need = 4; break;
+                case InputEvent::START: case InputEvent::END: need = 8; break;
+                default: return false;
+            }
+            if ((size_t)(end - p) < need) return false;
+
+            if (need == 1) e.a = p[0];
+            else if (need == 2) { e.a = p[0]; e.b = p[1]; }
+            else if (need == 4 && e.kind == InputEvent::RESIZE) { e.a = p[0] | (p[1] << 8); e.b = p[2] | (p[3] << 8); }
+            else if (need == 4) { e.a = (int16_t)(p[0] | (p[1] << 8)); e.b = (int16_t)(p[2] | (p[3] << 8)); }
+            else { const uint8_t *q = p; e.value = getU64(q); }
+            p += need;
+
+            Stamped s;
+            s.tick = tick;
+            s.e = e;
+            events.push_back(s);
+        }
+        return true;
+    }
+
+    // last tick the recording covers (its END, or the last event)
+    long endTick() const { return events.empty() ? 0 : events.back().tick; }
+
+    // END checksum, false if the recording was cut short
+    bool expectedChecksum(uint64_t &out) const {
+        if (events.empty() || events.back().e.kind != InputEvent::END) return false;
+        out = events.back().e.value;
+        return true;
+    }
+
+    // Apply every event stamped for the tick w is about to run.
+    // playing flips to true on START, like startPlaying() does live.
+    void applyDue(GameWorld &w, bool &playing) {
+        while (next < events.size() && events[next].tick <= w.tick) {
+            const InputEvent &e = events[next++].e;
+            if (e.kind == InputEvent::START) {
+                Simulation::resetForPlay(w, e.value);
+                playing = true;
+            } else if (e.kind == InputEvent::RESIZE) {
+                w.aspect = aspectOf(e.a, e.b);
+            } else {
+                e.apply(w.player, w.movement, w.shooting);
+            }
+        }
+    }
+
+    // the spawn aspect for a w x h window, the same division reshape() does
+    static float aspectOf(int width, int height) {
+        return (float)width / (float)std::max(height, 1);
+    }
+
+private:
+    std::FILE *out = nullptr;
+    long lastTick = 0;
+    size_t next = 0;
+
+    void putU8(uint8_t v) { std::fputc(v, out); }
+    void putU16(uint16_t v) { putU8((uint8_t)v); putU8((uint8_t)(v >> 8)); }
+    void putU64(uint64_t v) { for (int i = 0; i < 8; i++) putU8((uint8_t)(v >> (8 * i))); }
+
+    void putVarint(uint64_t v) {
+        while (v >= 0x80) { putU8((uint8_t)(v | 0x80)); v >>= 7; }
+        putU8((uint8_t)v);
+    }
+
+    static uint64_t getU64(const uint8_t *&p) {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; i++) v |= (uint64_t)p[i] << (8 * i);
+        p += 8;
+        return v;
+    }
+
+    static bool getVarint(const uint8_t *&p, const uint8_t *end, uint64_t &v) {
+        v = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            uint8_t c = *p++;
+            v |= (uint64_t)(c & 0x7f) << shift;
+            if (!(c & 0x80)) return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fork-join job system for the simulation's data-parallel loops.
+// start(n) runs n - 1 worker threads; the calling thread is worker 0 and helps
+// out while it waits. parallelFor() cuts [0, n) into chunks, deals them round
+// robin onto the per-thread deques, and every thread pops from the back of its
+// own deque and steals from the front of the others' when it runs dry.
+//
+// Chunks only ever cover disjoint index ranges and each element is computed
+// exactly as the serial loop would, so results do not depend on the thread
+// count. Nothing allocates after start(): jobs are plain structs in fixed rings
+// and the loop body is passed by pointer (it lives on the caller's stack until
+// every chunk has finished).
+class JobSystem {
+public:
+    JobSystem() {}
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+    ~JobSystem() { stop(); }
+
+    // total threads including the caller, 1 = everything runs inline
+    void start(int threads) {
+        stop();
+        if (threads < 1) threads = 1;
+
+        deques.clear();
+        for (int i = 0; i < threads; i++) deques.emplace_back(new Deque());
+
+        quit = false;
+        for (int i = 1; i < threads; i++) workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    void stop() {
+        if (workers.empty()) return;
+        {
+            std::lock_guard<std::mutex> lk(sleepM);
+            quit = true;
+        }
+        sleepCv.notify_all();
+        for (auto &t : workers) t.join();
+        workers.clear();
+    }
+
+    int threadCount() const { return (int)workers.size() + 1; }
+
+    // js if a loop over n items is big enough to split, else null (inline).
+    // Dealing chunks and waking the workers costs tens of microseconds, so
+    // a loop that finishes faster than that is quicker on the calling thread.
+    static JobSystem *ifAtLeast(JobSystem *js, int n, int minItems) {
+        return n >= minItems ? js : nullptr;
+    }
+
+    // fn(begin, end) over [0, n) in chunks of grain (the last one may be short).
+    // Runs inline without a job system, with one thread, or when one chunk covers it.
+    template <class Fn>
+    static void parallelFor(JobSystem *js, int n, int grain, const Fn &fn) {
+        if (n <= 0) return;
+        if (grain < 1) grain = 1;
+        if (!js || js->workers.empty() || n <= grain) { fn(0, n); return; }
+        js->run(n, grain, &fn, [](const void *ctx, int b, int e) { (*(const Fn *)ctx)(b, e); });
+    }
+
+private:
+    struct Job {
+        void (*fn)(const void *, int, int);
+        const void *ctx;
+        int begin, end;
+    };
+
+    // Owner pushes / pops at the back, thieves take from the front.
+    // A mutex per deque is plenty at a few dozen chunks per loop.
+    struct Deque {
+        static const int CAP = 256;
+        std::mutex m;
+        Job ring[CAP];
+        int head = 0, count = 0;
+
+        bool push(const Job &j) {
+            std::lock_guard<std::mutex> lk(m);
+            if (count == CAP) return false;
+            ring[(head + count) % CAP] = j;
+            count++;
+            return true;
+        }
+        bool popBack(Job &j) {
+            std::lock_guard<std::mutex> lk(m);
+            if (count == 0) return false;
+            count--;
+            j = ring[(head + count) % CAP];
+            return true;
+        }
+        bool stealFront(Job &j) {
+            std::lock_guard<std::mutex> lk(m);
+            if (count == 0) return false;
+            j = ring[head];
+            head = (head + 1) % CAP;
+            count--;
+            return true;
+        }
+    };
+
+    std::vector<std::unique_ptr<Deque>> deques;   // [0] = calling thread
+    std::vector<std::thread> workers;
+
+    std::atomic<int> pending{0};        // chunks not finished yet
+    std::atomic<unsigned> epoch{0};     // bumped whenever new chunks are dealt
+
+    std::mutex sleepM;
+    std::condition_variable sleepCv;
+    bool quit = false;
+
+    void run(int n, int grain, const void *ctx, void (*fn)(const void *, int, int)) {
+        const int T = (int)deques.size();
+        int chunks = (n + grain - 1) / grain;
+
+        pending.fetch_add(chunks);
+        for (int c = 0; c < chunks; c++) {
+            Job j = { fn, ctx, c * grain, std::min(n, (c + 1) * grain) };
+            if (!deques[c % T]->push(j)) execute(j);   // ring full, just do it
+        }
+        {
+            std::lock_guard<std::mutex> lk(sleepM);
+            epoch.fetch_add(1);
+        }
+        sleepCv.notify_all();
+
+        // help until every chunk is done (some may still be running elsewhere)
+        Job j;
+        while (pending.load() > 0) {
+            if (findWork(0, j)) execute(j);
+            else std::this_thread::yield();
+        }
+    }
+
+    void execute(const Job &j) {
+        j.fn(j.ctx, j.begin, j.end);
+        pending.fetch_sub(1);
+    }
+
+    bool findWork(int self, Job &j) {
+        if (deques[self]->popBack(j)) return true;
+        const int T = (int)deques.size();
+        for (int k = 1; k < T; k++) {
+            if (deques[(self + k) % T]->stealFront(j)) return true;
+        }
+        return false;
+    }
+
+    void workerLoop(int self) {
+        Job j;
+        for (;;) {
+            unsigned seen = epoch.load();
+
+            // spin a little first: ticks come every few microseconds under load
+            bool worked = false;
+            for (int spin = 0; spin < 2000; spin++) {
+                if (findWork(self, j)) { execute(j); worked = true; spin = 0; }
+                else if (pending.load() == 0) break;
+            }
+            if (worked) continue;
+
+            std::unique_lock<std::mutex> lk(sleepM);
+            sleepCv.wait(lk, [&] { return quit || epoch.load() != seen; });
+            if (quit) return;
+        }
+    }
+};
@@ -0,0 +1,125 @@
+#include <vector>
+#include <algorithm>
+
+// NOTE: expects Pool.cpp and JobSystem.cpp to be included before this file.
+// Storage for everything that flies in a straight line until it runs out:
+// player bullets, enemy bullets, explosions, meteors. Each kind is one
+// archetype, a Movers<Extra>: the motion components every kind shares
+// (x, y, vx, vy, life) in contiguous arrays of their own, plus an array of
+// the kind's own component (Extra, e.g. a bullet's angle). Two systems then
+// serve every kind instead of a hand-written loop each:
+//
+//   integrate(step)  x += vx, y += vy, life -= step
+//   sweep()          kills whatever has no life left
+//
+// Slot bookkeeping is Pool's (spawn order, holes, the oldest evicted when
+// full, slots never move), so iteration order, kill(slot) and the cap
+// behaviour are the same as with a Pool of structs.
+struct NoExtra {};
+
+template <class Extra = NoExtra>
+class Movers {
+public:
+    // One item's components, by reference: `for (auto b : movers) b.life = 0;`
+    // writes through. Iterate by value (or const auto &), never auto &.
+    struct Ref {
+        float &x, &y;
+        float &vx, &vy;
+        float &life;
+        Extra &extra;
+    };
+    struct ConstRef {
+        const float &x, &y;
+        const float &vx, &vy;
+        const float &life;
+        const Extra &extra;
+    };
+
+    explicit Movers(int capacity)
+        : slots(capacity), x(capacity, 0.0f), y(capacity, 0.0f),
+          vx(capacity, 0.0f), vy(capacity, 0.0f), life(capacity, 0.0f) {}
+
+    int capacity() const { return slots.capacity(); }
+    int size() const { return slots.size(); }
+    bool empty() const { return slots.empty(); }
+    void clear() { slots.clear(); }
+
+    // add at the tail, evicting the oldest if full; returns the slot
+    int spawn(float x0, float y0, float vx0, float vy0, float life0, const Extra &e = Extra()) {
+        int s = slots.spawn(e).slot;
+        x[s] = x0; y[s] = y0;
+        vx[s] = vx0; vy[s] = vy0;
+        life[s] = life0;
+        return s;
+    }
+
+    void kill(int slot) { slots.kill(slot); }
+
+    // Holes are integrated too: skipping them would cost a branch per item
+    // and spawn() overwrites every component anyway. Items are independent,
+    // so with jobs the span is split into chunks of grain.
+    void integrate(float lifeStep, JobSystem *jobs = nullptr, int grain = 256) {
+        JobSystem::parallelFor(jobs, slots.extent(), grain, [&](int k0, int k1) {
+            integrateRange(k0, k1, lifeStep);
+        });
+    }
+
+    void sweep() {
+        slots.removeSlotsIf([this](int s) { return life[s] <= 0.0f; });
+    }
+
+    Ref operator[](int s) { return Ref{x[s], y[s], vx[s], vy[s], life[s], slots[s]}; }
+    ConstRef operator[](int s) const { return ConstRef{x[s], y[s], vx[s], vy[s], life[s], slots[s]}; }
+
+    // ---------- iteration over live items, oldest first ----------
+    template <class M, class R, class It>
+    class Iter {
+    public:
+        Iter(M *m, It it) : m(m), it(it) {}
+
+        R operator*() const { return (*m)[it.slot()]; }
+        Iter &operator++() { ++it; return *this; }
+        bool operator!=(const Iter &o) const { return it != o.it; }
+
+        // where this item lives (for kill() / operator[])
+        int slot() const { return it.slot(); }
+
+    private:
+        M *m;
+        It it;
+    };
+
+    typedef Iter<Movers, Ref, typename Pool<Extra>::const_iterator> iterator;
+    typedef Iter<const Movers, ConstRef, typename Pool<Extra>::const_iterator> const_iterator;
+
+    iterator begin() { return iterator(this, cslots().begin()); }
+    iterator end() { return iterator(this, cslots().end()); }
+    const_iterator begin() const { return const_iterator(this, slots.begin()); }
+    const_iterator end() const { return const_iterator(this, slots.end()); }
+
+private:
+    Pool<Extra> slots;   // bookkeeping + the Extra component
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> life;
+
+    const Pool<Extra> &cslots() const { return slots; }
+
+    // offsets [k0, k1) as at most two contiguous runs (the ring may wrap)
+    void integrateRange(int k0, int k1, float lifeStep) {
+        const int cap = slots.capacity();
+        while (k0 < k1) {
+            const int s = slots.slotAt(k0);
+            const int n = std::min(k1 - k0, cap - s);
+
+            float *px = &x[s], *py = &y[s], *pl = &life[s];
+            const float *pvx = &vx[s], *pvy = &vy[s];
+            for (int i = 0; i < n; i++) {
+                px[i] += pvx[i];
+                py[i] += pvy[i];
+                pl[i] -= lifeStep;
+            }
+            k0 += n;
+        }
+    }
+};
@@ -12,6 +12,10 @@ public:
     float angle = 0.0f;
     float scale = 1.0f;
 
+    // position after the previous tick, the renderer blends from here to x/y
+    float prevX = 0.0f;
+    float prevY = 0.0f;
+
     // animation params
     float armSwing = 0.0f;
     float legSwing = 0.0f;
@@ -96,14 +100,14 @@ public:
         setBaseWithHit(baseR, baseG, baseB, headHitT);
         glPushMatrix();
         glTranslatef(bodyX, 0.22f + bodyY, 0.0f);
-        Shapes::Circle(0.10f, 60);
+        glCallList(meshes().head);
         glPopMatrix();
 
         // visor (cyan)
         glColor3f(0.4f, 0.9f, 1.0f);
         glPushMatrix();
         glTranslatef(bodyX + 0.03f, 0.22f + bodyY, 0.0f);
-        Shapes::Circle(0.055f, 50);
+        glCallList(meshes().visor);
         glPopMatrix();
 
         // ---------- ARMS ----------
@@ -127,7 +131,7 @@ public:
 
         glPushMatrix();
         glTranslatef(leftHandX, leftHandY, 0.0f);
-        Shapes::Circle(0.03f, 40);
+        glCallList(meshes().hand);
         glPopMatrix();
 
         drawGun(leftHandX + aimHandX - recoilX,
@@ -151,7 +155,7 @@ public:
 
         glPushMatrix();
         glTranslatef(rightHandX, rightHandY, 0.0f);
-        Shapes::Circle(0.03f, 40);
+        glCallList(meshes().hand);
         glPopMatrix();
 
         drawGun(rightHandX + aimHandX - recoilX,
@@ -177,6 +181,67 @@ public:
     }
 
 private:
+    // The fixed-shape parts compiled once into display lists, on the first
+    // draw (needs the GL context). Lists hold geometry only, colours are set
+    // by draw(): the skin and the hit glow change them every frame anyway, so
+    // setColorIndex() has nothing to invalidate. The gun keeps its own fixed
+    // colours inside the list.
+    struct Meshes {
+        GLuint head = 0, visor = 0, hand = 0, gun = 0, flash = 0;
+    };
+
+    // one set per Shapes LOD level, compiled the first time that level is drawn
+    static const Meshes &meshes() {
+        static Meshes levels[Shapes::LOD_LEVELS + 1];
+
+        const int level = Shapes::lodLevel();
+        Meshes &m = levels[level];
+        if (m.head) return m;
+
+        Shapes::LodScope lod(Shapes::lodLevelPixels(level));
+
+        GLuint base = glGenLists(5);
+        m.head = base; m.visor = base + 1; m.hand = base + 2; m.gun = base + 3; m.flash = base + 4;
+
+        glNewList(m.head, GL_COMPILE);  Shapes::Circle(0.10f, 60);  glEndList();
+        glNewList(m.visor, GL_COMPILE); Shapes::Circle(0.055f, 50); glEndList();
+        glNewList(m.hand, GL_COMPILE);  Shapes::Circle(0.03f, 40);  glEndList();
+
+        glNewList(m.gun, GL_COMPILE);
+        {
+            // barrel (ash)
+            glColor3f(0.55f, 0.55f, 0.55f);
+            Shapes::Rectangle(0.14f, 0.03f);
+
+            // top rail
+            glColor3f(0.35f, 0.35f, 0.35f);
+            glPushMatrix();
+            glTranslatef(0.03f, 0.02f, 0.0f);
+            Shapes::Rectangle(0.10f, 0.01f);
+            glPopMatrix();
+
+            // handle (brown)
+            glColor3f(0.45f, 0.25f, 0.12f);
+            glPushMatrix();
+            glTranslatef(-0.04f, -0.06f, 0.0f);
+            Shapes::Rectangle(0.03f, 0.07f);
+            glPopMatrix();
+        }
+        glEndList();
+
+        glNewList(m.flash, GL_COMPILE);
+        {
+            glColor3f(1.0f, 0.35f, 0.0f);
+            glPushMatrix();
+            glTranslatef(0.09f, 0.0f, 0.0f);
+            Shapes::Circle(0.02f, 14);
+            glPopMatrix();
+        }
+        glEndList();
+
+        return m;
+    }
+
     static void palette(int idx, float &r, float &g, float &b) {
         // 10 cool colors
         switch (idx) {
@@ -207,38 +272,15 @@ private:
         glTranslatef(gx, gy, 0.0f);
         glRotatef(angleDeg, 0, 0, 1);
 
-        // barrel (ash)
-        glColor3f(0.55f, 0.55f, 0.55f);
-        Shapes::Rectangle(0.14f, 0.03f);
-
-        // top rail
-        glColor3f(0.35f, 0.35f, 0.35f);
-        glPushMatrix();
-        glTranslatef(0.03f, 0.02f, 0.0f);
-        Shapes::Rectangle(0.10f, 0.01f);
-        glPopMatrix();
-
-        // handle (brown)
-        glColor3f(0.45f, 0.25f, 0.12f);
-        glPushMatrix();
-        glTranslatef(-0.04f, -0.06f, 0.0f);
-        Shapes::Rectangle(0.03f, 0.07f);
-        glPopMatrix();
-
-        if (flash) {
-            glColor3f(1.0f, 0.35f, 0.0f);
-            glPushMatrix();
-            glTranslatef(0.09f, 0.0f, 0.0f);
-            Shapes::Circle(0.02f, 14);
-            glPopMatrix();
-        }
+        glCallList(meshes().gun);
+        if (flash) glCallList(meshes().flash);
 
         glPopMatrix();
     }
 
 
 };
-void drawPlayerPreviewAt(float cx, float cy, float scale, int colorIndex) {
+inline void drawPlayerPreviewAt(float cx, float cy, float scale, int colorIndex) {
     Player temp;
     temp.x = cx;
     temp.y = cy;
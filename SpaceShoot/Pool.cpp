@@ -0,0 +1,152 @@
+#include <vector>
+
+// Fixed-capacity ring of T for short-lived things (Movers keeps bullets,
+// explosions and meteors in one).
+// Everything is allocated once in the constructor; spawn and kill are O(1) and
+// never allocate. Items live in spawn order between head (oldest) and the tail.
+// A killed item leaves a hole that is skipped by iteration and reclaimed once
+// it reaches either end, which is quick because these things mostly die in the
+// order they were born (fixed lifetimes). When the ring is full, spawn()
+// overwrites the oldest slot, so the old "cap at N, drop the oldest" is free.
+//
+// Slots never move, so a slot index (or a Handle, which also catches reuse)
+// stays valid until that item is killed or evicted.
+template <class T>
+class Pool {
+public:
+    struct Handle {
+        int slot = -1;
+        unsigned gen = 0;
+    };
+
+    explicit Pool(int capacity)
+        : items(capacity), gens(capacity, 0), live(capacity, 0), cap(capacity) {}
+
+    int capacity() const { return cap; }
+    int size() const { return alive; }
+    bool empty() const { return alive == 0; }
+
+    void clear() {
+        for (int k = 0; k < span; k++) live[wrap(head + k)] = 0;
+        head = 0;
+        span = 0;
+        alive = 0;
+    }
+
+    // add at the tail, evicting the oldest item if there is no room
+    Handle spawn(const T &v) {
+        if (span == cap) {
+            if (live[head]) { live[head] = 0; alive--; }
+            head = wrap(head + 1);
+            span--;
+        }
+
+        int s = wrap(head + span);
+        items[s] = v;
+        live[s] = 1;
+        gens[s]++;
+        span++;
+        alive++;
+
+        Handle h;
+        h.slot = s;
+        h.gen = gens[s];
+        return h;
+    }
+
+    void kill(int slot) {
+        if (!live[slot]) return;
+        live[slot] = 0;
+        alive--;
+        trim();
+    }
+
+    bool valid(Handle h) const {
+        return h.slot >= 0 && h.slot < cap && live[h.slot] && gens[h.slot] == h.gen;
+    }
+
+    // Offsets from the oldest slot in use, holes included. Parallel loops split
+    // [0, extent()) and visit their part with forEachIn.
+    int extent() const { return span; }
+
+    template <class Fn>
+    void forEachIn(int k0, int k1, Fn fn) {
+        for (int k = k0; k < k1; k++) {
+            int s = wrap(head + k);
+            if (live[s]) fn(items[s]);
+        }
+    }
+
+    // the slot at offset k from the oldest (k < extent())
+    int slotAt(int k) const { return wrap(head + k); }
+
+    T &operator[](int slot) { return items[slot]; }
+    const T &operator[](int slot) const { return items[slot]; }
+
+    // kill every item pred(item) says is done (one pass, no shifting)
+    template <class Pred>
+    void removeIf(Pred pred) {
+        for (int k = 0; k < span; k++) {
+            int s = wrap(head + k);
+            if (live[s] && pred(items[s])) { live[s] = 0; alive--; }
+        }
+        trim();
+    }
+
+    // the same, for callers that keep more per-slot data next to the pool
+    template <class Pred>
+    void removeSlotsIf(Pred pred) {
+        for (int k = 0; k < span; k++) {
+            int s = wrap(head + k);
+            if (live[s] && pred(s)) { live[s] = 0; alive--; }
+        }
+        trim();
+    }
+
+    // ---------- iteration over live items, oldest first ----------
+    template <class P, class V>
+    class Iter {
+    public:
+        Iter(P *p, int k) : pool(p), k(k) { skip(); }
+
+        V &operator*() const { return pool->items[slot()]; }
+        V *operator->() const { return &pool->items[slot()]; }
+        Iter &operator++() { k++; skip(); return *this; }
+        bool operator!=(const Iter &o) const { return k != o.k; }
+
+        // where this item lives (for kill() / operator[])
+        int slot() const { return pool->wrap(pool->head + k); }
+
+    private:
+        P *pool;
+        int k;   // offset from head
+
+        void skip() { while (k < pool->span && !pool->live[slot()]) k++; }
+    };
+
+    typedef Iter<Pool, T> iterator;
+    typedef Iter<const Pool, const T> const_iterator;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, span); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, span); }
+
+private:
+    std::vector<T> items;
+    std::vector<unsigned> gens;
+    std::vector<char> live;
+
+    int cap;
+    int head = 0;    // oldest slot
+    int span = 0;    // slots in use from head, holes included
+    int alive = 0;
+
+    int wrap(int i) const { return i >= cap ? i - cap : i; }
+
+    // drop holes at both ends
+    void trim() {
+        while (span > 0 && !live[head]) { head = wrap(head + 1); span--; }
+        while (span > 0 && !live[wrap(head + span - 1)]) span--;
+    }
+};
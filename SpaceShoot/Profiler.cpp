@@ -0,0 +1,290 @@
+#include <GL/glut.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+// Per-stage frame profiler. Wrap a stage in a Profiler::Scope; the time adds up
+// into that stage for the current frame (a frame may run several ticks), and
+// endFrame() closes the frame: one CSV row if a file is open, and one sample in
+// a ring of the last WINDOW frames for the rolling min / avg / p99 overlay.
+// While disabled a Scope costs one branch, no clock reads.
+// Counters (drawn / total per kind of world object from view culling, the
+// audio voices in use, the scratch arenas' peak) are plain last-frame values.
+class Profiler {
+public:
+    typedef std::chrono::steady_clock clock;
+
+    enum Stage {
+        // simulation (summed over the frame's ticks)
+        MOVE = 0,       // movement, player animation, shooting, background
+        ENEMIES,        // EnemySystem::update (spawn, chase, separation)
+        ENEMY_COMBAT,   // EnemyCombat::update
+        COLLISION,      // Collision::bulletEnemy
+        FX,             // Effects::update
+        AUDIO,          // sound triggers in main.cpp
+        // drawing
+        DRAW_BG,
+        DRAW_ENEMIES,   // enemies + enemy bullets
+        DRAW_FX,
+        DRAW_PLAYER,    // aim line, player bullets, player
+        DRAW_HUD,
+        // CPU time of the audio mixer thread during the frame (from add())
+        AUDIO_MIX,
+        // wall time from one endFrame() to the next
+        FRAME,
+        STAGE_COUNT
+    };
+
+    // what the view culling kept, per kind of object
+    enum Counter {
+        CULL_ENEMIES = 0,
+        CULL_ENEMY_BULLETS,
+        CULL_BULLETS,
+        CULL_BOOMS,
+        CULL_PLANETS,
+        // mixer voices playing, of the pool
+        AUDIO_VOICES,
+        // Arena peak of the last tick / frame in KB, of the block
+        TICK_ARENA,
+        FRAME_ARENA,
+        COUNTER_COUNT
+    };
+
+    static const int WINDOW = 300;   // frames in the rolling stats (~5 s at 60)
+
+    struct Stats {
+        float minMs = 0.0f, avgMs = 0.0f, p99Ms = 0.0f;
+    };
+
+    bool enabled = false;
+    bool overlay = false;
+    long frames = 0;
+
+    class Scope {
+    public:
+        Scope(Profiler &p, Stage s) : prof(p.enabled ? &p : nullptr), stage(s) {
+            if (prof) t0 = clock::now();
+        }
+        ~Scope() {
+            if (prof) prof->cur[stage] += std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+        }
+    private:
+        Profiler *prof;
+        Stage stage;
+        clock::time_point t0;
+    };
+
+    static const char *name(int s) {
+        static const char *names[STAGE_COUNT] = {
+            "move", "enemies", "enemy_combat", "collision", "fx", "audio",
+            "draw_bg", "draw_enemies", "draw_fx", "draw_player", "draw_hud",
+            "audio_mix", "frame"
+        };
+        return names[s];
+    }
+
+    static const char *counterName(int c) {
+        static const char *names[COUNTER_COUNT] = {
+            "enemies", "enemy_bullets", "bullets", "booms", "planets", "voices",
+            "tick_arena", "frame_arena"
+        };
+        return names[c];
+    }
+
+    // time measured somewhere a Scope cannot reach (another thread)
+    void add(Stage s, float ms) {
+        if (enabled) cur[s] += ms;
+    }
+
+    void count(Counter c, int drawn, int total) {
+        if (!enabled) return;
+        drawnNow[c] = drawn;
+        totalNow[c] = total;
+        countedNow[c] = true;
+    }
+
+    // Folds in what another Profiler collected since the last merge and
+    // clears it there: stage times add up, counters it set replace ours.
+    // The window build gives the sim thread its own Profiler (GameWorld::prof)
+    // and merges it on the main thread after SimThread::wait(), so the two
+    // threads never write the same one.
+    void merge(Profiler &from) {
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            cur[s] += from.cur[s];
+            from.cur[s] = 0.0f;
+        }
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            if (!from.countedNow[c]) continue;
+            drawnNow[c] = from.drawnNow[c];
+            totalNow[c] = from.totalNow[c];
+            from.countedNow[c] = false;
+        }
+    }
+
+    void toggleOverlay() {
+        overlay = !overlay;
+        enabled = overlay || csv;
+        lastFrame = clock::now();
+    }
+
+    // per-frame rows (ms per stage) until the program ends
+    bool openCsv(const char *path) {
+        csv = std::fopen(path, "w");
+        if (!csv) return false;
+
+        std::fprintf(csv, "frame,ticks");
+        for (int s = 0; s < STAGE_COUNT; s++) std::fprintf(csv, ",%s_ms", name(s));
+        for (int c = 0; c < COUNTER_COUNT; c++) std::fprintf(csv, ",%s_drawn,%s_total", counterName(c), counterName(c));
+        std::fprintf(csv, "\n");
+
+        enabled = true;
+        lastFrame = clock::now();
+        return true;
+    }
+
+    void closeCsv() {
+        if (csv) std::fclose(csv);
+        csv = nullptr;
+        enabled = overlay;
+    }
+
+    void addTicks(int n) { curTicks += n; }
+
+    void endFrame() {
+        if (!enabled) return;
+
+        clock::time_point now = clock::now();
+        cur[FRAME] = std::chrono::duration<float, std::milli>(now - lastFrame).count();
+        lastFrame = now;
+
+        if (csv) {
+            std::fprintf(csv, "%ld,%d", frames, curTicks);
+            for (int s = 0; s < STAGE_COUNT; s++) std::fprintf(csv, ",%.4f", cur[s]);
+            for (int c = 0; c < COUNTER_COUNT; c++) std::fprintf(csv, ",%d,%d", drawnNow[c], totalNow[c]);
+            std::fprintf(csv, "\n");
+        }
+
+        if ((int)ring.size() < WINDOW * STAGE_COUNT) ring.resize(WINDOW * STAGE_COUNT, 0.0f);
+        int slot = (int)(frames % WINDOW);
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            ring[s * WINDOW + slot] = cur[s];
+            cur[s] = 0.0f;
+        }
+        curTicks = 0;
+        frames++;
+    }
+
+    // rolling stats over the last min(frames, WINDOW) frames
+    Stats stats(int s) const {
+        Stats st;
+        int n = (int)std::min<long>(frames, WINDOW);
+        if (n == 0 || ring.empty()) return st;
+
+        scratch.assign(ring.begin() + s * WINDOW, ring.begin() + s * WINDOW + n);
+
+        float sum = 0.0f;
+        st.minMs = scratch[0];
+        for (float v : scratch) { sum += v; st.minMs = std::min(st.minMs, v); }
+        st.avgMs = sum / n;
+
+        int k = std::min(n - 1, (int)(n * 0.99f));
+        std::nth_element(scratch.begin(), scratch.begin() + k, scratch.end());
+        st.p99Ms = scratch[k];
+        return st;
+    }
+
+    // Top-left table, the Scoreboard HUD owns the top-right corner.
+    // Stats are refreshed a few times a second so reading them stays cheap.
+    void drawOverlay(int screenW, int screenH) {
+        if (!overlay) return;
+
+        if (frames - shownAt >= 15 || frames < shownAt) {
+            for (int s = 0; s < STAGE_COUNT; s++) shown[s] = stats(s);
+            shownAt = frames;
+        }
+
+        glDisable(GL_DEPTH_TEST);
+
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        gluOrtho2D(0, screenW, 0, screenH);
+
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        const int x = 10;
+        const int lineH = 14;
+        const int lines = STAGE_COUNT + 1 + COUNTER_COUNT + 1;
+        int y = screenH - 18;
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glColor4f(0.0f, 0.0f, 0.0f, 0.55f);
+        glBegin(GL_QUADS);
+            glVertex2i(x - 6, y + lineH);
+            glVertex2i(x + 300, y + lineH);
+            glVertex2i(x + 300, y - lines * lineH);
+            glVertex2i(x - 6, y - lines * lineH);
+        glEnd();
+        glDisable(GL_BLEND);
+
+        char buf[96];
+        glColor3f(0.6f, 1.0f, 0.6f);
+        std::snprintf(buf, sizeof(buf), "%-13s %7s %7s %7s", "stage (ms)", "min", "avg", "p99");
+        drawText(x, y, buf);
+
+        for (int s = 0; s < STAGE_COUNT; s++) {
+            y -= lineH;
+            // stutter suspects in red: p99 over 4 ms for a stage
+            if (shown[s].p99Ms > 4.0f && s != FRAME) glColor3f(1.0f, 0.4f, 0.4f);
+            else glColor3f(0.9f, 0.9f, 0.9f);
+
+            std::snprintf(buf, sizeof(buf), "%-13s %7.3f %7.3f %7.3f",
+                          name(s), shown[s].minMs, shown[s].avgMs, shown[s].p99Ms);
+            drawText(x, y, buf);
+        }
+
+        y -= lineH;
+        glColor3f(0.6f, 1.0f, 0.6f);
+        std::snprintf(buf, sizeof(buf), "%-13s %7s %7s", "counters", "used", "of");
+        drawText(x, y, buf);
+
+        glColor3f(0.9f, 0.9f, 0.9f);
+        for (int c = 0; c < COUNTER_COUNT; c++) {
+            y -= lineH;
+            std::snprintf(buf, sizeof(buf), "%-13s %7d %7d", counterName(c), drawnNow[c], totalNow[c]);
+            drawText(x, y, buf);
+        }
+        Text::flush();
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+
+        glEnable(GL_DEPTH_TEST);
+    }
+
+private:
+    float cur[STAGE_COUNT] = {};
+    int curTicks = 0;
+    int drawnNow[COUNTER_COUNT] = {};
+    int totalNow[COUNTER_COUNT] = {};
+    bool countedNow[COUNTER_COUNT] = {};   // set since the last merge (see merge())
+    clock::time_point lastFrame = clock::now();
+
+    std::vector<float> ring;             // [stage][WINDOW]
+    mutable std::vector<float> scratch;  // for stats()
+
+    Stats shown[STAGE_COUNT];
+    long shownAt = 0;
+
+    std::FILE *csv = nullptr;
+
+    static void drawText(int x, int y, const char *s) {
+        Text::draw((float)x, (float)y, GLUT_BITMAP_8_BY_13, s);
+    }
+};
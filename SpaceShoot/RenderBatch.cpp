@@ -0,0 +1,257 @@
+#include <GL/glut.h>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Collects coloured triangles and lines on the CPU, already transformed to world
+// space, and submits each kind with one glDrawArrays on flush(). Replaces the
+// glPushMatrix / glTranslatef / glBegin / glEnd around every little shape.
+//
+// Plain GL 1.1 client-side vertex arrays, no extensions, so it runs on any
+// driver including Mesa's software rasterizers.
+class RenderBatch {
+public:
+    struct Vertex {
+        float x, y;
+        unsigned char r, g, b, a;
+    };
+
+    // Geometry recorded once in local space (beginMesh .. endMesh) and stamped
+    // out per instance with a translation and a colour. Vertices recorded after
+    // tint(k) take k times the instance colour, the rest keep their own colour.
+    // Tinted vertices come in runs of one colour, so stamp() works that out
+    // once per run, not per vertex.
+    struct Mesh {
+        struct Run {
+            int end;        // one past the run's last vertex
+            bool tinted;
+        };
+        std::vector<Vertex> tris, lines;
+        std::vector<Run> trisRuns, linesRuns;
+    };
+
+    // stats since the last resetStats()
+    int drawCalls = 0;
+    int vertices = 0;
+
+    RenderBatch() { reset(); }
+
+    // ---------- transform (same idea as the GL matrix stack, 2D only) ----------
+    void push() {
+        if (depth + 1 < MAX_DEPTH) { stack[depth + 1] = stack[depth]; depth++; }
+    }
+    void pop() { if (depth > 0) depth--; }
+
+    void translate(float tx, float ty) {
+        Affine &m = stack[depth];
+        m.tx += m.a * tx + m.c * ty;
+        m.ty += m.b * tx + m.d * ty;
+    }
+
+    void rotate(float deg) {
+        float t = deg * 3.1415926f / 180.0f;
+        float cs = std::cos(t), sn = std::sin(t);
+        Affine &m = stack[depth];
+        float a = m.a * cs + m.c * sn;
+        float b = m.b * cs + m.d * sn;
+        float c = m.c * cs - m.a * sn;
+        float d = m.d * cs - m.b * sn;
+        m.a = a; m.b = b; m.c = c; m.d = d;
+    }
+
+    void scale(float sx, float sy) {
+        Affine &m = stack[depth];
+        m.a *= sx; m.b *= sx;
+        m.c *= sy; m.d *= sy;
+    }
+
+    // ---------- colour ----------
+    void color(float r, float g, float b, float a = 1.0f) {
+        cur.r = toByte(r); cur.g = toByte(g); cur.b = toByte(b); cur.a = toByte(a);
+        curTint = false;
+    }
+
+    // while recording a mesh: k times whatever colour stamp() is given
+    void tint(float k) {
+        color(k, k, k);
+        curTint = true;
+    }
+
+    // ---------- cached meshes ----------
+    void beginMesh() {
+        clear();
+        reset();
+        recording = true;
+    }
+
+    Mesh endMesh() {
+        Mesh m;
+        m.tris = tris;
+        m.lines = lines;
+        m.trisRuns = runsOf(tris, trisTint);
+        m.linesRuns = runsOf(lines, linesTint);
+        recording = false;
+        clear();
+        return m;
+    }
+
+    // mesh at (tx, ty) in the current transform, tinted parts in (r, g, b)
+    void stamp(const Mesh &m, float tx, float ty, float r, float g, float b) {
+        push();
+        translate(tx, ty);
+        const Affine t = stack[depth];
+        pop();
+
+        const unsigned char ir = toByte(r), ig = toByte(g), ib = toByte(b);
+        stampInto(tris, m.tris, m.trisRuns, t, ir, ig, ib);
+        stampInto(lines, m.lines, m.linesRuns, t, ir, ig, ib);
+    }
+
+    // ---------- primitives (local coordinates) ----------
+    void tri(float x0, float y0, float x1, float y1, float x2, float y2) {
+        emit(tris, x0, y0);
+        emit(tris, x1, y1);
+        emit(tris, x2, y2);
+    }
+
+    void quad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3) {
+        tri(x0, y0, x1, y1, x2, y2);
+        tri(x0, y0, x2, y2, x3, y3);
+    }
+
+    void line(float x0, float y0, float x1, float y1) {
+        emit(lines, x0, y0);
+        emit(lines, x1, y1);
+    }
+
+    // Draws everything collected so far (triangles, then lines) and empties the
+    // batch. Uses whatever GL matrices / depth / blend state is current.
+    void flush() {
+        if (tris.empty() && lines.empty()) return;
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+
+        submit(tris.data(), (int)tris.size(), GL_TRIANGLES);
+        submit(lines.data(), (int)lines.size(), GL_LINES);
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        clear();
+    }
+
+    // Draws a triangle list kept somewhere else (a cached mesh that does not
+    // change every frame) straight away, without copying it into the batch.
+    void drawTriangles(const Vertex *v, int count) {
+        if (count <= 0) return;
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        submit(v, count, GL_TRIANGLES);
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+    }
+
+    // drop everything collected so far without drawing it
+    void clear() {
+        tris.clear();
+        lines.clear();
+        trisTint.clear();
+        linesTint.clear();
+    }
+
+    // forget transform + colour (start of a layer)
+    void reset() {
+        depth = 0;
+        stack[0] = Affine();
+        color(1.0f, 1.0f, 1.0f);
+    }
+
+    void resetStats() { drawCalls = 0; vertices = 0; }
+
+private:
+    struct Affine {
+        // x' = a*x + c*y + tx,  y' = b*x + d*y + ty
+        float a = 1.0f, b = 0.0f, c = 0.0f, d = 1.0f;
+        float tx = 0.0f, ty = 0.0f;
+    };
+
+    static const int MAX_DEPTH = 16;
+    Affine stack[MAX_DEPTH];
+    int depth = 0;
+
+    Vertex cur{};
+    bool curTint = false;
+
+    std::vector<Vertex> tris;    // GL_TRIANGLES
+    std::vector<Vertex> lines;   // GL_LINES
+
+    // only filled between beginMesh and endMesh
+    bool recording = false;
+    std::vector<unsigned char> trisTint, linesTint;
+
+    static unsigned char toByte(float v) {
+        v = std::max(0.0f, std::min(1.0f, v));
+        return (unsigned char)(v * 255.0f + 0.5f);
+    }
+
+    void emit(std::vector<Vertex> &out, float x, float y) {
+        const Affine &m = stack[depth];
+        Vertex v = cur;
+        v.x = m.a * x + m.c * y + m.tx;
+        v.y = m.b * x + m.d * y + m.ty;
+        out.push_back(v);
+        if (recording) (&out == &tris ? trisTint : linesTint).push_back(curTint ? 1 : 0);
+    }
+
+    static unsigned char scaleByte(unsigned char a, unsigned char k) {
+        return (unsigned char)((a * k + 127) / 255);
+    }
+
+    // split at every change of tint flag or colour
+    static std::vector<Mesh::Run> runsOf(const std::vector<Vertex> &v, const std::vector<unsigned char> &tinted) {
+        std::vector<Mesh::Run> runs;
+        for (int i = 0; i < (int)v.size(); i++) {
+            bool same = i > 0 && tinted[i] == tinted[i - 1] &&
+                        v[i].r == v[i - 1].r && v[i].g == v[i - 1].g &&
+                        v[i].b == v[i - 1].b && v[i].a == v[i - 1].a;
+            if (same) runs.back().end = i + 1;
+            else runs.push_back({ i + 1, tinted[i] != 0 });
+        }
+        return runs;
+    }
+
+    static void stampInto(std::vector<Vertex> &out, const std::vector<Vertex> &src,
+                          const std::vector<Mesh::Run> &runs, const Affine &t,
+                          unsigned char r, unsigned char g, unsigned char b) {
+        if (src.empty()) return;
+        size_t base = out.size();
+        out.resize(base + src.size());
+        Vertex *dst = &out[base];
+
+        int i = 0;
+        for (const Mesh::Run &run : runs) {
+            Vertex c = src[i];
+            if (run.tinted) {
+                c.r = scaleByte(r, c.r);
+                c.g = scaleByte(g, c.g);
+                c.b = scaleByte(b, c.b);
+            }
+            for (; i < run.end; i++) {
+                c.x = t.a * src[i].x + t.c * src[i].y + t.tx;
+                c.y = t.b * src[i].x + t.d * src[i].y + t.ty;
+                dst[i] = c;
+            }
+        }
+    }
+
+    void submit(const Vertex *v, int count, GLenum mode) {
+        if (count <= 0) return;
+        glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &v[0].x);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &v[0].r);
+        glDrawArrays(mode, 0, (GLsizei)count);
+        drawCalls++;
+        vertices += count;
+    }
+};
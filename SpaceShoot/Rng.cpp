@@ -0,0 +1,61 @@
+#include <cstdint>
+
+// Small seedable PRNG (PCG32, O'Neill 2014): 64-bit state, 32-bit output.
+// Every subsystem that needs randomness owns one, seeded from the run seed plus
+// its own stream id, so the streams never share state. Background generation
+// no longer shifts enemy spawns, and the same seed replays the same run on every
+// compiler (std::rand differs between MinGW and glibc).
+class Rng {
+public:
+    // one stream per subsystem, the value only has to be unique
+    enum Stream : uint64_t {
+        BACKGROUND   = 1,
+        ENEMIES      = 2,
+        ENEMY_COMBAT = 3,
+        BENCH        = 100
+    };
+
+    Rng() { seed(1, 0); }
+    Rng(uint64_t s, uint64_t stream) { seed(s, stream); }
+
+    void seed(uint64_t s, uint64_t stream) {
+        state = 0;
+        inc = (stream << 1) | 1u;   // must be odd
+        next();
+        state += s;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+        uint32_t rot = (uint32_t)(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+
+    // [0, 1)
+    float unit() {
+        return (float)(next() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // [a, b)
+    float range(float a, float b) {
+        return a + (b - a) * unit();
+    }
+
+    // [0, n), n > 0
+    int below(int n) {
+        return (int)(((uint64_t)next() * (uint64_t)n) >> 32);
+    }
+
+    // [a, b] inclusive
+    int rangeInt(int a, int b) {
+        if (b <= a) return a;
+        return a + below(b - a + 1);
+    }
+
+private:
+    uint64_t state = 0;
+    uint64_t inc = 1;
+};
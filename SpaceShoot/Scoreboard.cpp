@@ -55,35 +55,22 @@ public:
         glPushMatrix();
         glLoadIdentity();
 
-        int minutes = elapsedSec / 60;
-        int seconds = elapsedSec % 60;
-
-        char timeBuf[64];
-        std::snprintf(timeBuf, sizeof(timeBuf), "%d:%02d", minutes, seconds);
-
-        char scoreBuf[64];
-        std::snprintf(scoreBuf, sizeof(scoreBuf), "Score : %d", score);
-
-        char levelBuf[64];
-        std::snprintf(levelBuf, sizeof(levelBuf), "Level : %d", level);
+        const Lines &l = lines(elapsedSec, score, level);
 
         // Right-aligned HUD block (tight to top-right, no overlaps)
         const int rightEdge = screenW - 12;
         const int topY = screenH - 18;
         const int lineH = 22;
 
-        int wTime  = textWidth(timeBuf);
-        int wScore = textWidth(scoreBuf);
-        int wLevel = textWidth(levelBuf);
-
-        int xTime  = rightEdge - wTime;
-        int xScore = rightEdge - wScore;
-        int xLevel = rightEdge - wLevel;
+        int xTime  = rightEdge - l.wTime;
+        int xScore = rightEdge - l.wScore;
+        int xLevel = rightEdge - l.wLevel;
 
         glColor3f(1, 0, 0);
-        drawText(xTime,  topY,             timeBuf);
-        drawText(xScore, topY - lineH,     scoreBuf);
-        drawText(xLevel, topY - 2*lineH,   levelBuf);
+        Text::draw((float)xTime,  (float)topY,             GLUT_BITMAP_HELVETICA_18, l.time);
+        Text::draw((float)xScore, (float)(topY - lineH),   GLUT_BITMAP_HELVETICA_18, l.score);
+        Text::draw((float)xLevel, (float)(topY - 2*lineH), GLUT_BITMAP_HELVETICA_18, l.level);
+        Text::flush();
 
         // Health bar under the text, aligned to the same right edge
         int barY = topY - 3*lineH - 8;
@@ -105,19 +92,35 @@ private:
         return 10 * mult;
     }
 
-    static void drawText(int x, int y, const char* s) {
-        glRasterPos2i(x, y);
-        for (int i = 0; s[i] != '\0'; i++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, s[i]);
+    // The HUD strings and their widths, formatted again only when a value
+    // changes (the clock once a second, score and level on kills). Kept
+    // outside the Scoreboard: every render snapshot copies that from the live
+    // world, which never draws, so a cache in there would start cold each frame.
+    struct Lines {
+        int sec = -1, pts = -1, lvl = -1;
+        char time[16], score[32], level[32];
+        int wTime = 0, wScore = 0, wLevel = 0;
+    };
+
+    static const Lines &lines(int sec, int pts, int lvl) {
+        static Lines l;   // main thread only, like all drawing
+
+        if (sec != l.sec) {
+            l.sec = sec;
+            std::snprintf(l.time, sizeof(l.time), "%d:%02d", sec / 60, sec % 60);
+            l.wTime = Text::width(GLUT_BITMAP_HELVETICA_18, l.time);
         }
-    }
-
-    static int textWidth(const char* s) {
-        int w = 0;
-        for (int i = 0; s[i] != '\0'; i++) {
-            w += glutBitmapWidth(GLUT_BITMAP_HELVETICA_18, s[i]);
+        if (pts != l.pts) {
+            l.pts = pts;
+            std::snprintf(l.score, sizeof(l.score), "Score : %d", pts);
+            l.wScore = Text::width(GLUT_BITMAP_HELVETICA_18, l.score);
+        }
+        if (lvl != l.lvl) {
+            l.lvl = lvl;
+            std::snprintf(l.level, sizeof(l.level), "Level : %d", lvl);
+            l.wLevel = Text::width(GLUT_BITMAP_HELVETICA_18, l.level);
         }
-        return w;
+        return l;
     }
 
     static void drawRect2D(float x, float y, float w, float h, bool filled) {
@@ -1,8 +1,101 @@
 #include <GL/glut.h>
+#include <algorithm>
 #include <cmath>
+#include <vector>
+
+#include "RenderBatch.cpp"
+
+// Unit-circle points for every segment count up to MAX_SEGMENTS, built once on
+// first use: at(n)[2*i], at(n)[2*i+1] = cos, sin of 2*pi*i/n for i = 0..n
+// (point n repeats point 0 exactly, so fans and rings close without a seam).
+// Saves a cos + sin per vertex on every circle drawn each frame.
+class CircleTable {
+public:
+    static const int MAX_SEGMENTS = 128;
+
+    // nullptr if n is out of range (callers fall back to std::cos/std::sin)
+    static const float *at(int n) {
+        static const CircleTable table;   // thread-safe one-time init
+        if (n < 1 || n > MAX_SEGMENTS) return nullptr;
+        return &table.points[table.offset[n]];
+    }
+
+private:
+    std::vector<float> points;
+    int offset[MAX_SEGMENTS + 1];
+
+    CircleTable() {
+        offset[0] = 0;
+        for (int n = 1; n <= MAX_SEGMENTS; n++) {
+            offset[n] = (int)points.size();
+            for (int i = 0; i < n; i++) {
+                double t = 2.0 * 3.14159265358979 * i / n;
+                points.push_back((float)std::cos(t));
+                points.push_back((float)std::sin(t));
+            }
+            points.push_back(1.0f);
+            points.push_back(0.0f);
+        }
+    }
+};
 
 class Shapes {
 public:
+    // ---------- level of detail ----------
+    // While pixelsPerUnit() is set (display() does for the world layers), the
+    // circle shapes below use just enough segments for their projected size:
+    // the segments' flat edges stay within LOD_ERROR_PX of the true circle.
+    // The segment count passed in is the most they ever use. 0 = off, full
+    // counts (menus, previews, Bench).
+    static constexpr float LOD_ERROR_PX = 0.5f;
+    static constexpr int LOD_MIN_SEGMENTS = 6;
+
+    // Cached geometry (enemy meshes, player display lists) is built once per
+    // level: pixelsPerUnit rounded up to 32 * 2^level, LOD_LEVELS = off.
+    static constexpr int LOD_LEVELS = 7;
+
+    static float &pixelsPerUnit() {
+        static float px = 0.0f;   // only touched by the thread that draws
+        return px;
+    }
+
+    // world units -> pixels on the z = 0 plane, for the 60 degree perspective
+    // set in reshape() seen from height zoom
+    static float pixelsPerUnitAt(float zoom, int screenH) {
+        return screenH / (2.0f * zoom * 0.57735f);
+    }
+
+    // sets pixelsPerUnit() for a scope, then puts the old value back
+    class LodScope {
+    public:
+        explicit LodScope(float px) : saved(pixelsPerUnit()) { pixelsPerUnit() = px; }
+        ~LodScope() { pixelsPerUnit() = saved; }
+    private:
+        float saved;
+    };
+
+    static int lodLevel() {
+        float px = pixelsPerUnit();
+        if (px <= 0.0f) return LOD_LEVELS;
+        int level = 0;
+        while (level < LOD_LEVELS - 1 && lodLevelPixels(level) < px) level++;
+        return level;
+    }
+
+    static float lodLevelPixels(int level) {
+        return level >= LOD_LEVELS ? 0.0f : 32.0f * (float)(1 << level);
+    }
+
+    // segments for a full circle of radius r: sagitta r * (1 - cos(pi / n))
+    // ~ r * pi^2 / (2 n^2) <= error
+    static int lodSegments(float r, int segments) {
+        float px = pixelsPerUnit();
+        if (px <= 0.0f) return segments;
+        float rPx = r * px;
+        int n = (int)std::ceil(3.14159265f * std::sqrt(rPx / (2.0f * LOD_ERROR_PX)));
+        return std::max(std::min(n, segments), std::min(LOD_MIN_SEGMENTS, segments));
+    }
+
     // Rectangle centered at (0,0)
     static void Rectangle(float w, float h) {
         glBegin(GL_QUADS);
@@ -24,21 +117,23 @@ public:
     }
 
     static void Circle(float r, int segments = 60) {
+        segments = lodSegments(r, segments);
+        const float *cs = circlePoints(segments, 1);
         glBegin(GL_TRIANGLE_FAN);
         glVertex2f(0.0f, 0.0f);
         for(int i = 0; i <= segments; i++) {
-            float t = 2.0f * 3.1415926f * i / segments;
-            glVertex2f(r * std::cos(t), r * std::sin(t));
+            glVertex2f(r * cs[2*i], r * cs[2*i + 1]);
         }
         glEnd();
     }
 
     static void HalfCircle(float r, int segments = 40) {
+        segments = (lodSegments(r, 2 * segments) + 1) / 2;
+        const float *cs = circlePoints(segments, 2);
         glBegin(GL_TRIANGLE_FAN);
         glVertex2f(0.0f, 0.0f);
         for(int i = 0; i <= segments; i++) {
-            float t = 3.1415926f * i / segments;
-            glVertex2f(r * std::cos(t), r * std::sin(t));
+            glVertex2f(r * cs[2*i], r * cs[2*i + 1]);
         }
         glEnd();
     }
@@ -50,6 +145,48 @@ public:
         glEnd();
     }
 
+    // ---------- batched versions (same shapes, appended to a RenderBatch) ----------
+    static void Rectangle(RenderBatch &b, float w, float h) {
+        b.quad(-w/2,  h/2,
+                w/2,  h/2,
+                w/2, -h/2,
+               -w/2, -h/2);
+    }
+
+    static void Triangle(RenderBatch &b, float size) {
+        b.tri(0.0f, size, size, -size, -size, -size);
+    }
+
+    static void Circle(RenderBatch &b, float r, int segments = 60) {
+        segments = lodSegments(r, segments);
+        const float *cs = circlePoints(segments, 1);
+        for (int i = 1; i <= segments; i++) {
+            b.tri(0.0f, 0.0f,
+                  r * cs[2*i - 2], r * cs[2*i - 1],
+                  r * cs[2*i],     r * cs[2*i + 1]);
+        }
+    }
+
+    static void HalfCircle(RenderBatch &b, float r, int segments = 40) {
+        segments = (lodSegments(r, 2 * segments) + 1) / 2;
+        const float *cs = circlePoints(segments, 2);
+        for (int i = 1; i <= segments; i++) {
+            b.tri(0.0f, 0.0f,
+                  r * cs[2*i - 2], r * cs[2*i - 1],
+                  r * cs[2*i],     r * cs[2*i + 1]);
+        }
+    }
+
+    static void Ring(RenderBatch &b, float r1, float r2, int segments = 40) {
+        segments = lodSegments(std::max(r1, r2), segments);
+        const float *cs = circlePoints(segments, 1);
+        for (int i = 1; i <= segments; i++) {
+            float pc = cs[2*i - 2], ps = cs[2*i - 1];
+            float cx = cs[2*i],     cy = cs[2*i + 1];
+            b.quad(pc * r1, ps * r1, pc * r2, ps * r2, cx * r2, cy * r2, cx * r1, cy * r1);
+        }
+    }
+
     // Shiny 5-point star (filled). twinkle: 0..1
     static void Star5Shiny(float outerR, float innerR, float twinkle = 1.0f) {
         float outerBright = std::min(1.0f, 0.92f * twinkle + 0.08f);
@@ -58,14 +195,12 @@ public:
         struct P { float x, y; };
         P outer[5], inner[5];
 
-        const float PI = 3.1415926f;
-        float a0 = -PI * 0.5f;
-
+        // points alternate outer/inner every 36 degrees starting at -90:
+        // cos(t - 90) = sin(t), sin(t - 90) = -cos(t)
+        const float *cs = CircleTable::at(10);
         for (int i = 0; i < 5; i++) {
-            float ao = a0 + i * (2.0f * PI / 5.0f);
-            float ai = ao + (PI / 5.0f);
-            outer[i] = { outerR * std::cos(ao), outerR * std::sin(ao) };
-            inner[i] = { innerR * std::cos(ai), innerR * std::sin(ai) };
+            outer[i] = { outerR * cs[4*i + 1], -outerR * cs[4*i] };
+            inner[i] = { innerR * cs[4*i + 3], -innerR * cs[4*i + 2] };
         }
 
         // halo
@@ -120,4 +255,22 @@ public:
 
         glDisable(GL_BLEND);
     }
+
+private:
+    // Points of a circle cut into segments*fraction pieces; the first
+    // segments+1 of them are the shape. fraction 2 gives the upper half.
+    // Counts past the table are computed into a scratch buffer instead.
+    static const float *circlePoints(int segments, int fraction) {
+        int n = segments * fraction;
+        if (const float *cs = CircleTable::at(n)) return cs;
+
+        static std::vector<float> scratch;
+        scratch.resize(2 * (segments + 1));
+        for (int i = 0; i <= segments; i++) {
+            float t = 2.0f * 3.1415926f * i / n;
+            scratch[2*i]     = std::cos(t);
+            scratch[2*i + 1] = std::sin(t);
+        }
+        return scratch.data();
+    }
 };
@@ -5,10 +5,8 @@
 
 class Shooting {
 public:
-    struct Bullet {
-        float x, y;
-        float vx, vy;
-        float life;
+    // what a bullet has on top of Movers' motion components
+    struct Look {
         float angleDeg;
     };
 
@@ -25,7 +23,9 @@ public:
     int fireDelay = 8;        // lower = faster
     float bulletSpeed = 0.22f;
 
-    std::vector<Bullet> bullets;
+    // 2 bullets every fireDelay ticks, 140 ticks each: ~36 alive at most
+    static const int MAX_BULLETS = 128;
+    Movers<Look> bullets{MAX_BULLETS};
 
     // called every frame
     void setAimFromWorld(float playerX, float playerY, float worldX, float worldY) {
@@ -56,15 +56,8 @@ public:
         }
 
         // move bullets
-        for (auto &b : bullets) {
-            b.x += b.vx;
-            b.y += b.vy;
-            b.life -= 1.0f;
-        }
-
-        bullets.erase(std::remove_if(bullets.begin(), bullets.end(),
-                                     [](const Bullet& b){ return b.life <= 0.0f; }),
-                      bullets.end());
+        bullets.integrate(1.0f);
+        bullets.sweep();
     }
 
     // draw aim preview + bullets
@@ -96,22 +89,35 @@ public:
         glLineWidth(1.0f);
     }
 
-    void drawBullets() const {
+    // bullets fly straight, so the previous tick's position is x - vx
+    // returns how many bullets were on screen (the rest are culled)
+    int drawBullets(RenderBatch &batch, float alpha = 1.0f, const ViewRect &view = ViewRect::everything()) const {
+        batch.reset();
+
+        const float back = 1.0f - alpha;
+        int drawn = 0;
         for (const auto &b : bullets) {
-            glPushMatrix();
-            glTranslatef(b.x, b.y, 0.0f);
-            glRotatef(b.angleDeg, 0,0,1);
+            float x = b.x - b.vx * back, y = b.y - b.vy * back;
+            if (!view.visible(x, y, 0.07f)) continue;
+            drawn++;
+
+            batch.push();
+            batch.translate(x, y);
+            batch.rotate(b.extra.angleDeg);
 
             // bright core
-            glColor3f(1.0f, 0.25f, 0.25f);
-            Shapes::Rectangle(0.12f, 0.03f);
+            batch.color(1.0f, 0.25f, 0.25f);
+            Shapes::Rectangle(batch, 0.12f, 0.03f);
 
             // glow layer
-            glColor3f(1.0f, 0.65f, 0.25f);
-            Shapes::Rectangle(0.07f, 0.06f);
+            batch.color(1.0f, 0.65f, 0.25f);
+            Shapes::Rectangle(batch, 0.07f, 0.06f);
 
-            glPopMatrix();
+            batch.pop();
         }
+
+        batch.flush();
+        return drawn;
     }
 
 private:
@@ -139,12 +145,8 @@ private:
     }
 
     void spawnBullet(float x, float y) {
-        Bullet b;
-        b.x = x; b.y = y;
-        b.vx = aimX * bulletSpeed;
-        b.vy = aimY * bulletSpeed;
-        b.life = 140.0f;
-        b.angleDeg = aimAngleDeg;
-        bullets.push_back(b);
+        Look look;
+        look.angleDeg = aimAngleDeg;
+        bullets.spawn(x, y, aimX * bulletSpeed, aimY * bulletSpeed, 140.0f, look);
     }
 };
@@ -0,0 +1,194 @@
+#include <cmath>
+#include <ctime>
+#include <cstdint>
+#include <algorithm>
+
+// NOTE: expects every gameplay class (Player .. EnemyCombat) to be included before this file.
+// main.cpp (window) and Headless.cpp (no window) both drive the game through this.
+
+// Everything one gameplay tick reads or writes.
+struct GameWorld {
+    Player player;
+    Movement movement;
+    PlayerMove playerMove;
+
+    Background bg;
+    EnemySystem enemies;
+
+    Scoreboard hud;
+    Shooting shooting;
+    Effects fx;
+    Collision collision;
+    EnemyCombat enemyCombat;
+
+    float zoom = 2.0f;
+    float targetZoom = 2.0f;
+    float prevZoom = 2.0f;     // zoom after the previous tick (render interpolation)
+    float aspect = 640.0f / 480.0f;
+
+    // the run's seed, every subsystem derives its own Rng stream from it
+    uint64_t seed = 0;
+
+    // ticks run since init() (input logs are stamped with this)
+    long tick = 0;
+
+    // stage timings, off unless the overlay or a CSV dump is on
+    Profiler prof;
+
+    // worker threads for the heavy stages, none until someone calls jobs.start()
+    JobSystem jobs;
+
+    // temporaries of one tick, dropped at its end
+    Arena scratch{256 * 1024};
+};
+
+class Simulation {
+public:
+    // seed 0 = pick one from the clock (the window build); anything else
+    // reproduces the run exactly
+    static uint64_t resolveSeed(uint64_t seed) {
+        return seed != 0 ? seed : (uint64_t)std::time(nullptr);
+    }
+
+    // first-time setup (what main() used to do before entering the loop)
+    static void init(GameWorld &w, uint64_t seed = 0) {
+        w.seed = resolveSeed(seed);
+        w.tick = 0;
+        w.enemies.jobs = &w.jobs;
+        w.bg.init(w.seed);
+        w.enemies.init(w.seed);
+        w.enemyCombat.init(w.seed);
+        w.collision.scratch = &w.scratch;
+        w.hud.reset();
+
+        w.player.x = 0.0f;
+        w.player.y = 0.0f;
+        w.player.scale = 1.0f;
+
+        savePrevious(w);
+    }
+
+    // fresh run when PLAY is pressed
+    static void resetForPlay(GameWorld &w, uint64_t seed = 0) {
+        w.seed = resolveSeed(seed);
+        w.hud.reset();
+
+        w.enemies.init(w.seed);
+        w.enemyCombat.init(w.seed);
+        w.fx.booms.clear();
+
+        Player &player = w.player;
+        player.x = 0.0f;
+        player.y = 0.0f;
+        player.hp = 100;
+        player.invuln = 0;
+
+        player.headHitT  = 0.0f;
+        player.bodyHitT  = 0.0f;
+        player.leftHitT  = 0.0f;
+        player.rightHitT = 0.0f;
+        player.legsHitT  = 0.0f;
+
+        w.shooting = Shooting();
+
+        w.zoom = 2.0f;
+        w.targetZoom = 2.0f;
+
+        // nothing to blend from after a teleport to the origin
+        savePrevious(w);
+    }
+
+    // Snapshot what the renderer interpolates (player, enemies, camera zoom).
+    // Bullets move in a straight line, their previous position is x - vx.
+    static void savePrevious(GameWorld &w) {
+        w.player.prevX = w.player.x;
+        w.player.prevY = w.player.y;
+        w.enemies.enemies.savePrevious();
+        w.prevZoom = w.zoom;
+    }
+
+    // One fixed gameplay step (FixedStep::tickHz, 60 by default). playing = false
+    // is the HOME screen (player can still walk and shoot, no enemies).
+    static void tick(GameWorld &w, bool playing) {
+        savePrevious(w);
+        w.tick++;
+
+        // smooth zoom
+        if (w.targetZoom < 1.2f) w.targetZoom = 1.2f;
+        if (w.targetZoom > 6.0f) w.targetZoom = 6.0f;
+        w.zoom += (w.targetZoom - w.zoom) * 0.18f;
+
+        {
+            Profiler::Scope prof(w.prof, Profiler::MOVE);
+
+            // allow movement + aim + shooting update even in HOME
+            w.movement.update(w.player, w.targetZoom);
+            w.playerMove.update(w.player, w.movement);
+
+            w.shooting.update(w.player);
+
+            w.bg.update(w.player, w.movement);
+        }
+
+        if (playing) {
+            w.hud.update();
+            w.enemies.setDifficulty(w.hud.level);
+
+            {
+                Profiler::Scope prof(w.prof, Profiler::ENEMIES);
+                w.enemies.update(w.player, w.zoom, w.aspect);
+            }
+            {
+                Profiler::Scope prof(w.prof, Profiler::ENEMY_COMBAT);
+                w.enemyCombat.update(w.enemies, w.player);
+            }
+
+            w.player.updateDamageTimers();
+            {
+                Profiler::Scope prof(w.prof, Profiler::COLLISION);
+                w.collision.bulletEnemy(w.shooting, w.enemies, w.fx, w.hud);
+            }
+
+            {
+                Profiler::Scope prof(w.prof, Profiler::FX);
+                w.fx.update();
+            }
+            // enemy bullets / explosions are capped by their pools (oldest goes)
+        } else {
+            // HOME
+            w.player.updateDamageTimers();
+
+            Profiler::Scope prof(w.prof, Profiler::FX);
+            w.fx.update();
+        }
+
+        w.scratch.reset();
+        w.prof.count(Profiler::TICK_ARENA, w.scratch.lastPeakKB(), w.scratch.capacityKB());
+    }
+
+    // FNV-1a over the gameplay state (bit patterns, not values), for checking
+    // that a replay ended exactly where the recording did.
+    static uint64_t checksum(const GameWorld &w) {
+        uint64_t h = 1469598103934665603ULL;
+        auto mix = [&h](const void *p, size_t n) {
+            const unsigned char *c = (const unsigned char *)p;
+            for (size_t i = 0; i < n; i++) { h ^= c[i]; h *= 1099511628211ULL; }
+        };
+        auto mixF = [&mix](const std::vector<float> &v) {
+            if (!v.empty()) mix(v.data(), v.size() * sizeof(float));
+        };
+
+        mix(&w.tick, sizeof(w.tick));
+        mix(&w.player.x, sizeof(float));
+        mix(&w.player.y, sizeof(float));
+        mix(&w.player.hp, sizeof(int));
+        mix(&w.hud.score, sizeof(int));
+        mix(&w.hud.level, sizeof(int));
+
+        mixF(w.enemies.enemies.x);
+        mixF(w.enemies.enemies.y);
+        for (const auto &b : w.shooting.bullets) { mix(&b.x, sizeof(float)); mix(&b.y, sizeof(float)); }
+        for (const auto &b : w.enemyCombat.bullets) { mix(&b.x, sizeof(float)); mix(&b.y, sizeof(float)); }
+        return h;
+    }
+};
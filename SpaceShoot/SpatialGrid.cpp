@@ -0,0 +1,188 @@
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Uniform grid over an unbounded 2D world, hashed into a fixed bucket table.
+// Rebuilt from scratch with a counting sort, so every bucket is one contiguous
+// run of items (ascending index) and a query is just a few short array walks.
+// Each item's x, y and radius are copied into bucket order at build time, so
+// queries never touch the caller's storage. Buffers are kept between rebuilds,
+// nothing allocates once it has warmed up.
+class SpatialGrid {
+public:
+    float cellSize = 0.33f;
+
+    // items [0, indexed) are in the grid, anything appended after the last
+    // build() has to be checked by the caller
+    int indexed = 0;
+
+    void clear() { indexed = 0; }
+
+    // size every buffer for up to n items now, so build() never allocates
+    void reserve(int n) {
+        int want = 64;
+        while (want < 2 * n) want *= 2;
+        cellStart.reserve(want + 1);
+        cursor.reserve(want);
+        items.reserve(n);
+        xs.reserve(n); ys.reserve(n); rs.reserve(n);
+        cellX.reserve(n); cellY.reserve(n);
+        tmpX.reserve(n); tmpY.reserve(n); tmpR.reserve(n);
+        itemBucket.reserve(n);
+    }
+
+    // itemOf(i, x, y, r) fills in position + radius of item i
+    template <class ItemFn>
+    void build(int n, ItemFn itemOf) {
+        int want = 64;
+        while (want < 2 * n) want *= 2;
+        if ((int)cellStart.size() != want + 1) cellStart.assign(want + 1, 0);
+        else std::fill(cellStart.begin(), cellStart.end(), 0);
+        mask = want - 1;
+        invCell = 1.0f / cellSize;
+
+        tmpX.resize(n); tmpY.resize(n); tmpR.resize(n);
+        itemBucket.resize(n);
+        items.resize(n);
+        xs.resize(n); ys.resize(n); rs.resize(n);
+        cellX.resize(n); cellY.resize(n);
+        indexed = n;
+
+        for (int i = 0; i < n; i++) {
+            itemOf(i, tmpX[i], tmpY[i], tmpR[i]);
+            int b = bucketOf(cellOf(tmpX[i]), cellOf(tmpY[i]));
+            itemBucket[i] = b;
+            cellStart[b + 1]++;
+        }
+        for (int b = 0; b < want; b++) cellStart[b + 1] += cellStart[b];
+
+        // scatter in index order -> every bucket stays sorted
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (int i = 0; i < n; i++) {
+            int k = cursor[itemBucket[i]]++;
+            items[k] = i;
+            xs[k] = tmpX[i];
+            ys[k] = tmpY[i];
+            rs[k] = tmpR[i];
+            cellX[k] = cellOf(xs[k]);
+            cellY[k] = cellOf(ys[k]);
+        }
+    }
+
+    struct Range { int begin, end; };
+
+    // Slot accessors for forEachNeighbourhood (slot = position in bucket order).
+    int   item(int k) const { return items[k]; }
+    float x(int k) const { return xs[k]; }
+    float y(int k) const { return ys[k]; }
+    float r(int k) const { return rs[k]; }
+
+    // All-pairs helper: calls fn(k, nb, nNb) for every indexed slot k in bucket
+    // order, where nb[0..nNb) are the slot ranges of the 3x3 cells around k's
+    // cell (k itself included). Only valid if cellSize >= the interaction
+    // distance. The ranges are rebuilt only when the cell changes, so a crowd
+    // packed into a few cells pays for the bucket lookups once, not per item.
+    // [begin, end) restricts it to some slots (one chunk of a parallel loop).
+    template <class Fn>
+    void forEachNeighbourhood(Fn fn) const {
+        forEachNeighbourhood(0, indexed, fn);
+    }
+
+    template <class Fn>
+    void forEachNeighbourhood(int begin, int end, Fn fn) const {
+        Range nb[9];
+        int nNb = 0;
+        int curX = 0, curY = 0;
+        bool have = false;
+
+        for (int k = begin; k < end; k++) {
+            if (!have || cellX[k] != curX || cellY[k] != curY) {
+                curX = cellX[k];
+                curY = cellY[k];
+                have = true;
+
+                int seen[9];
+                nNb = 0;
+                for (int cy = curY - 1; cy <= curY + 1; cy++) {
+                    for (int cx = curX - 1; cx <= curX + 1; cx++) {
+                        int b = bucketOf(cx, cy);
+
+                        bool dup = false;
+                        for (int s = 0; s < nNb; s++) if (seen[s] == b) { dup = true; break; }
+                        if (dup || cellStart[b] == cellStart[b + 1]) continue;
+
+                        seen[nNb] = b;
+                        nb[nNb++] = { cellStart[b], cellStart[b + 1] };
+                    }
+                }
+            }
+            fn(k, nb, nNb);
+        }
+    }
+
+    // Calls fn(i, x, y, r) for every indexed item whose cell touches the
+    // rectangle (candidates only, the caller does the exact test), with the
+    // values captured at build(). Each item is visited at most once.
+    // fn returns true to stop early; query() then returns true.
+    template <class Fn>
+    bool query(float minX, float minY, float maxX, float maxY, Fn fn) const {
+        if (indexed == 0) return false;
+
+        int x0 = cellOf(minX), x1 = cellOf(maxX);
+        int y0 = cellOf(minY), y1 = cellOf(maxY);
+
+        // huge rectangle: cheaper (and simpler) to walk everything once
+        const int MAX_CELLS = 64;
+        if ((x1 - x0 + 1) * (y1 - y0 + 1) > MAX_CELLS) {
+            for (int k = 0; k < indexed; k++) {
+                if (fn(items[k], xs[k], ys[k], rs[k])) return true;
+            }
+            return false;
+        }
+
+        // different cells can hash to the same bucket, visit each bucket once
+        int seen[MAX_CELLS];
+        int nSeen = 0;
+
+        for (int cy = y0; cy <= y1; cy++) {
+            for (int cx = x0; cx <= x1; cx++) {
+                int b = bucketOf(cx, cy);
+
+                bool dup = false;
+                for (int s = 0; s < nSeen; s++) if (seen[s] == b) { dup = true; break; }
+                if (dup) continue;
+                seen[nSeen++] = b;
+
+                for (int k = cellStart[b]; k < cellStart[b + 1]; k++) {
+                    if (fn(items[k], xs[k], ys[k], rs[k])) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    template <class Fn>
+    bool queryRadius(float x, float y, float reach, Fn fn) const {
+        return query(x - reach, y - reach, x + reach, y + reach, fn);
+    }
+
+private:
+    int mask = 0;
+    float invCell = 1.0f / 0.33f;
+
+    std::vector<int> cellStart;   // bucket b owns slots [cellStart[b], cellStart[b+1])
+    std::vector<int> items;       // slot -> item index
+    std::vector<float> xs, ys, rs;
+    std::vector<int> cellX, cellY;
+
+    std::vector<float> tmpX, tmpY, tmpR;
+    std::vector<int> itemBucket;
+    std::vector<int> cursor;
+
+    int cellOf(float v) const { return (int)std::floor(v * invCell); }
+
+    int bucketOf(int cx, int cy) const {
+        unsigned h = (unsigned)cx * 73856093u ^ (unsigned)cy * 19349663u;
+        return (int)(h & (unsigned)mask);
+    }
+};
@@ -0,0 +1,275 @@
+#include <GL/glut.h>
+#include <vector>
+#include <algorithm>
+
+// Bitmap text through one texture atlas instead of glutBitmapCharacter per
+// character. The first frame renders every printable character of the GLUT
+// fonts the game uses into the back buffer and copies that into a texture
+// (GL 1.1 has nothing better to read GLUT's glyphs back with); after that
+// draw() only queues one textured quad per character and flush() submits the
+// whole queue with a single glDrawArrays.
+//
+// draw() keeps the glRasterPos contract of the old helpers: (x, y) goes through
+// the current matrices, the colour is the current one, glyphs are pixel sized.
+// Call flush() at the end of each overlay so later layers still cover it.
+//
+// Until the atlas exists (or if the window is too small to build it in) text
+// falls back to glutBitmapCharacter, so nothing is ever missing.
+class Text {
+public:
+    // Builds the atlas if it is not there yet. Scribbles over the back buffer:
+    // call it before the frame's glClear.
+    static void prepare() {
+        Atlas &a = atlas();
+        if (a.texture) return;
+        a.build();
+    }
+
+    static void draw(float x, float y, void *font, const char *s) {
+        Atlas &a = atlas();
+        const Font *f = a.find(font);
+
+        if (!a.texture || !f) {
+            glRasterPos2f(x, y);
+            for (const char *p = s; *p; p++) glutBitmapCharacter(font, *p);
+            return;
+        }
+
+        // where and in which colour glutBitmapCharacter would have drawn
+        GLint valid = 0;
+        glRasterPos2f(x, y);
+        glGetIntegerv(GL_CURRENT_RASTER_POSITION_VALID, &valid);
+        if (!valid) return;
+
+        float pos[4], col[4];
+        glGetFloatv(GL_CURRENT_RASTER_POSITION, pos);
+        glGetFloatv(GL_CURRENT_RASTER_COLOR, col);
+
+        Vertex v;
+        v.r = toByte(col[0]); v.g = toByte(col[1]); v.b = toByte(col[2]); v.a = toByte(col[3]);
+
+        int penX = (int)(pos[0] + 0.5f);
+        const int baseY = (int)(pos[1] + 0.5f);
+        for (const char *p = s; *p; p++) {
+            int c = (unsigned char)*p;
+            if (c < FIRST || c > LAST) continue;
+
+            const Glyph &g = f->glyphs[c - FIRST];
+            float x0 = (float)(penX - PAD), x1 = x0 + f->cellW;
+            float y0 = (float)(baseY - f->base), y1 = y0 + f->cellH;
+
+            v.x = x0; v.y = y0; v.u = g.u0; v.v = g.v0; a.quads.push_back(v);
+            v.x = x1; v.y = y0; v.u = g.u1; v.v = g.v0; a.quads.push_back(v);
+            v.x = x1; v.y = y1; v.u = g.u1; v.v = g.v1; a.quads.push_back(v);
+            v.x = x0; v.y = y1; v.u = g.u0; v.v = g.v1; a.quads.push_back(v);
+
+            penX += g.advance;
+        }
+    }
+
+    // pixels, from the cached advances (no GLUT call after the first use)
+    static int width(void *font, const char *s) {
+        const Font *f = atlas().find(font);
+        int w = 0;
+        for (const char *p = s; *p; p++) {
+            int c = (unsigned char)*p;
+            if (!f) w += glutBitmapWidth(font, c);
+            else if (c >= FIRST && c <= LAST) w += f->glyphs[c - FIRST].advance;
+        }
+        return w;
+    }
+
+    // draws everything queued since the last flush in one call
+    static void flush() {
+        Atlas &a = atlas();
+        if (a.quads.empty()) return;
+
+        GLint vp[4];
+        glGetIntegerv(GL_VIEWPORT, vp);
+
+        glMatrixMode(GL_PROJECTION);
+        glPushMatrix();
+        glLoadIdentity();
+        gluOrtho2D(0, vp[2], 0, vp[3]);
+
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
+
+        glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, a.texture);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, sizeof(Vertex), &a.quads[0].x);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), &a.quads[0].u);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), &a.quads[0].r);
+        glDrawArrays(GL_QUADS, 0, (GLsizei)a.quads.size());
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+
+        glPopAttrib();
+
+        glPopMatrix();
+        glMatrixMode(GL_PROJECTION);
+        glPopMatrix();
+        glMatrixMode(GL_MODELVIEW);
+
+        a.quads.clear();
+    }
+
+private:
+    static const int FIRST = 32, LAST = 126;   // printable ASCII
+    static const int GLYPHS = LAST - FIRST + 1;
+    static const int COLUMNS = 16;
+    static const int PAD = 2;                  // room for glyphs that overhang their origin
+
+    struct Vertex {
+        float x, y;
+        float u, v;
+        unsigned char r, g, b, a;
+    };
+
+    struct Glyph {
+        int advance = 0;
+        float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+    };
+
+    struct Font {
+        void *id = nullptr;
+        int cellW = 0, cellH = 0;
+        int base = 0;                          // cell bottom to baseline
+        int atlasX = 0, atlasY = 0;            // cell (0, 0) in the atlas
+        Glyph glyphs[GLYPHS];
+    };
+
+    struct Atlas {
+        Font fonts[3];
+        bool measured = false;
+        GLuint texture = 0;
+        std::vector<Vertex> quads;
+
+        // metrics only need GLUT, not a context
+        void measure() {
+            if (measured) return;
+            measured = true;
+
+            // line heights by hand (plain GLUT has no glutBitmapHeight), with
+            // room for the tallest ASCII glyph and the deepest descender;
+            // 432 x 408 in all, so it fits the default 640 x 480 window
+            void *ids[3] = { GLUT_BITMAP_HELVETICA_18, GLUT_BITMAP_TIMES_ROMAN_24, GLUT_BITMAP_8_BY_13 };
+            const int heights[3] = { 24, 30, 14 };
+            int y = 0;
+            for (int i = 0; i < 3; i++) {
+                Font &f = fonts[i];
+                f.id = ids[i];
+
+                int maxAdvance = 0;
+                for (int c = FIRST; c <= LAST; c++) {
+                    f.glyphs[c - FIRST].advance = glutBitmapWidth(f.id, c);
+                    maxAdvance = std::max(maxAdvance, f.glyphs[c - FIRST].advance);
+                }
+
+                int lineH = heights[i];
+                f.cellW = maxAdvance + 2 * PAD;
+                f.cellH = lineH;
+                f.base = lineH / 4 + 1;
+                f.atlasX = 0;
+                f.atlasY = y;
+                y += f.cellH * ((GLYPHS + COLUMNS - 1) / COLUMNS);
+            }
+        }
+
+        const Font *find(void *font) {
+            measure();
+            for (const Font &f : fonts) if (f.id == font) return &f;
+            return nullptr;
+        }
+
+        void usedSize(int &w, int &h) const {
+            w = h = 0;
+            for (const Font &f : fonts) {
+                w = std::max(w, f.atlasX + f.cellW * COLUMNS);
+                h = std::max(h, f.atlasY + f.cellH * ((GLYPHS + COLUMNS - 1) / COLUMNS));
+            }
+        }
+
+        void build() {
+            measure();
+
+            int usedW, usedH;
+            usedSize(usedW, usedH);
+
+            GLint vp[4];
+            glGetIntegerv(GL_VIEWPORT, vp);
+            if (vp[2] < usedW || vp[3] < usedH) return;   // try again after a resize
+
+            int texW = 1, texH = 1;
+            while (texW < usedW) texW *= 2;
+            while (texH < usedH) texH *= 2;
+
+            glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT);
+            glMatrixMode(GL_PROJECTION);
+            glPushMatrix();
+            glLoadIdentity();
+            gluOrtho2D(0, vp[2], 0, vp[3]);
+            glMatrixMode(GL_MODELVIEW);
+            glPushMatrix();
+            glLoadIdentity();
+
+            glDisable(GL_DEPTH_TEST);
+            glDisable(GL_BLEND);
+            glDisable(GL_TEXTURE_2D);
+            glClearColor(0, 0, 0, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glColor3f(1, 1, 1);
+
+            for (Font &f : fonts) {
+                for (int i = 0; i < GLYPHS; i++) {
+                    int cx = f.atlasX + (i % COLUMNS) * f.cellW;
+                    int cy = f.atlasY + (i / COLUMNS) * f.cellH;
+                    glRasterPos2i(cx + PAD, cy + f.base);
+                    glutBitmapCharacter(f.id, FIRST + i);
+
+                    Glyph &g = f.glyphs[i];
+                    g.u0 = (float)cx / texW;
+                    g.v0 = (float)cy / texH;
+                    g.u1 = (float)(cx + f.cellW) / texW;
+                    g.v1 = (float)(cy + f.cellH) / texH;
+                }
+            }
+
+            // white on black, so intensity = coverage: GL_MODULATE then gives
+            // the vertex colour with the glyph as alpha
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_INTENSITY, texW, texH, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, nullptr);
+            glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, usedW, usedH);
+
+            glPopMatrix();
+            glMatrixMode(GL_PROJECTION);
+            glPopMatrix();
+            glMatrixMode(GL_MODELVIEW);
+            glPopAttrib();
+        }
+    };
+
+    static Atlas &atlas() {
+        static Atlas a;   // main thread only (it owns the GL context)
+        return a;
+    }
+
+    static unsigned char toByte(float c) {
+        c = std::max(0.0f, std::min(1.0f, c));
+        return (unsigned char)(c * 255.0f + 0.5f);
+    }
+};
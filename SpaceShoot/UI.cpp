@@ -169,6 +169,7 @@ private:
     }
 
     static void endOrtho() {
+        Text::flush();   // the panel's labels, in one go
         glDisable(GL_BLEND);
         glEnable(GL_DEPTH_TEST);
 
@@ -197,8 +198,7 @@ private:
     }
 
     static void drawText(float x, float y, void* font, const char* s) {
-        glRasterPos2f(x, y);
-        for (const char* p = s; *p; ++p) glutBitmapCharacter(font, *p);
+        Text::draw(x, y, font, s);
     }
 
     static void drawTriPlay(float cx, float cy, float s) {
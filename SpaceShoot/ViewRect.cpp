@@ -0,0 +1,65 @@
+#include <cmath>
+#include <algorithm>
+
+// The part of the z = 0 plane the camera can see, as a world-space rectangle.
+// display() looks straight down from (cx, cy, zoom) with a 60 degree
+// gluPerspective, then tilts the world around the player by rotX / rotY, so
+// the rectangle is the bounding box of where the four corner rays of the view
+// frustum hit the tilted plane. Draw code asks visible(x, y, r) per object and
+// skips what cannot be on screen.
+struct ViewRect {
+    float x0 = -1e30f, y0 = -1e30f;
+    float x1 =  1e30f, y1 =  1e30f;
+
+    // no culling (Bench, or callers that do not know the camera)
+    static ViewRect everything() { return ViewRect(); }
+
+    static ViewRect fromCamera(float cx, float cy, float zoom, float aspect,
+                               float rotXDeg, float rotYDeg) {
+        const float tanY = 0.57735f;            // tan(60 / 2)
+        const float tanX = tanY * aspect;
+        const float FAR = 100.0f;               // gluPerspective far plane
+
+        // world = T(c) Rx Ry T(-c) object, undo the tilt on the camera instead
+        const float ax = rotXDeg * 3.1415926f / 180.0f;
+        const float ay = rotYDeg * 3.1415926f / 180.0f;
+        const float cxr = std::cos(ax), sxr = std::sin(ax);
+        const float cyr = std::cos(ay), syr = std::sin(ay);
+
+        // (Rx Ry)^T v = Ry^T (Rx^T v)
+        auto untilt = [&](float vx, float vy, float vz, float &ox, float &oy, float &oz) {
+            float ty =  cxr * vy + sxr * vz;
+            float tz = -sxr * vy + cxr * vz;
+            ox = cyr * vx - syr * tz;
+            oy = ty;
+            oz = syr * vx + cyr * tz;
+        };
+
+        float ox, oy, oz;
+        untilt(0.0f, 0.0f, zoom, ox, oy, oz);   // camera, relative to (cx, cy)
+
+        ViewRect r;
+        r.x0 = r.y0 = 1e30f;
+        r.x1 = r.y1 = -1e30f;
+
+        static const float corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+        for (const auto &c : corners) {
+            float dx, dy, dz;
+            untilt(c[0] * tanX, c[1] * tanY, -1.0f, dx, dy, dz);
+
+            // rays at or above the horizon stop at the far plane
+            float t = (dz < -1e-4f) ? std::min(-oz / dz, FAR) : FAR;
+            float hx = cx + ox + dx * t;
+            float hy = cy + oy + dy * t;
+
+            r.x0 = std::min(r.x0, hx); r.x1 = std::max(r.x1, hx);
+            r.y0 = std::min(r.y0, hy); r.y1 = std::max(r.y1, hy);
+        }
+        return r;
+    }
+
+    // a circle of radius r at (x, y) overlaps the view
+    bool visible(float x, float y, float r) const {
+        return x + r >= x0 && x - r <= x1 && y + r >= y0 && y - r <= y1;
+    }
+};
@@ -1,10 +1,21 @@
 #include <GL/glut.h>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 // ===== Include your CPP-only “classes” in correct order =====
+#include "Rng.cpp"
+#include "Text.cpp"
+#include "Profiler.cpp"
+#include "Pool.cpp"
+#include "Arena.cpp"
+#include "JobSystem.cpp"
+#include "Movers.cpp"
 #include "Shapes.cpp"
+#include "ViewRect.cpp"
 #include "Player.cpp"
 #include "Movement.cpp"
 #include "PlayerMove.cpp"
@@ -15,16 +26,23 @@
 #include "Effects.cpp"
 #include "Collision.cpp"
 #include "EnemyCombat.cpp"
+#include "Simulation.cpp"
+#include "FixedStep.cpp"
+#include "FramePipeline.cpp"
+#include "InputLog.cpp"
 #include "UI.cpp"
+#include "AudioMixer.cpp"
 #include "Audio.cpp"
 #include "Input.cpp"
 
 // ===== Globals =====
-float zoom = 2.0f;
-float targetZoom = 2.0f;
+GameWorld world;
+
+float &zoom = world.zoom;
+float &targetZoom = world.targetZoom;
 
 int gW = 640, gH = 480;
-float g_aspect = 640.0f / 480.0f;
+float &g_aspect = world.aspect;
 
 // 0 = HOME, 1 = PLAYING
 int gameState = 0;
@@ -37,23 +55,43 @@ int gPrevHP    = 100;
 
 bool gPaused = false;
 
-Player player;
-Movement movement;
-PlayerMove playerMove;
+Player &player = world.player;
+Movement &movement = world.movement;
+
+Background &bg = world.bg;
+EnemySystem &enemies = world.enemies;
+
+Scoreboard &hud = world.hud;
+Shooting &shooting = world.shooting;
+Effects &fx = world.fx;
+EnemyCombat &enemyCombat = world.enemyCombat;
+
+// world-space shapes go through this (one draw call per layer)
+RenderBatch batch;
+
+// gameplay ticks at a fixed rate (--tick-hz), frames come as fast as vsync
+// allows, or --max-fps where the driver does not sync to vblank
+FixedStep simClock(60.0);
+int gMaxFps = 0;          // 0 = let vsync pace frames, otherwise a hard cap
+float gRenderAlpha = 1.0f;  // where display() sits between the last two ticks
 
-Background bg;
-EnemySystem enemies;
+// ticks run on simThread while the main thread draws the previous frame's snapshot
+TripleBuffer<RenderSnapshot> snapshots;
+SimThread simThread;
 
-Scoreboard hud;
-Shooting shooting;
-Effects fx;
-Collision collision;
-EnemyCombat enemyCombat;
+// --record <file>: log every input event for replay in the Headless target
+InputLog recorder;
+
+// F3 toggles the stage-timing overlay, --profile-csv <file> dumps every frame.
+// The ticks time themselves into world.prof on simThread; update() merges that
+// into this one after wait(), and only this thread ever touches prof.
+Profiler prof;
+
+void toggleProfiler() { prof.toggleOverlay(); }
 
 // --------------------------- text helpers ---------------------------
 static void drawBitmapString(float x, float y, void* font, const char* s) {
-    glRasterPos2f(x, y);
-    for (const char* p = s; *p; p++) glutBitmapCharacter(font, *p);
+    Text::draw(x, y, font, s);
 }
 
 static void drawPauseOverlay() {
@@ -91,6 +129,7 @@ static void drawPauseOverlay() {
 
     glColor3f(1.0f, 0.85f, 0.85f);
     drawBitmapString(-0.33f, -0.06f, GLUT_BITMAP_HELVETICA_18, "Press ENTER to continue");
+    Text::flush();
 
     glDisable(GL_BLEND);
     glEnable(GL_DEPTH_TEST);
@@ -103,27 +142,7 @@ static void drawPauseOverlay() {
 
 // ---------------------------------
 static void resetWorldForPlay() {
-    hud.reset();
-
-    enemies.init();
-    enemyCombat.bullets.clear();
-    fx.booms.clear();
-
-    player.x = 0.0f;
-    player.y = 0.0f;
-    player.hp = 100;
-    player.invuln = 0;
-
-    player.headHitT  = 0.0f;
-    player.bodyHitT  = 0.0f;
-    player.leftHitT  = 0.0f;
-    player.rightHitT = 0.0f;
-    player.legsHitT  = 0.0f;
-
-    shooting = Shooting();
-
-    zoom = 2.0f;
-    targetZoom = 2.0f;
+    Simulation::resetForPlay(world);
 
     gPaused = false;
 
@@ -135,51 +154,105 @@ static void resetWorldForPlay() {
 void startPlaying() {
     gameState = 1;
     resetWorldForPlay();
+    recorder.write(world.tick, InputEvent::make(InputEvent::START, 0, 0, world.seed));
     Audio::stopAllLoops();
     Audio::playGameBgm();
 }
 
+#ifdef _WIN32
+// opengl32 has no swap-interval entry point, it is an extension on Windows
+typedef BOOL (WINAPI *SwapIntervalProc)(int);
+static void enableVsync() {
+    SwapIntervalProc swapInterval = (SwapIntervalProc)wglGetProcAddress("wglSwapIntervalEXT");
+    if (swapInterval) swapInterval(1);
+}
+#else
+// Mesa / X drivers sync to vblank by default (vblank_mode, __GL_SYNC_TO_VBLANK)
+static void enableVsync() {}
+#endif
+
 // ---------------------------------
-static void display() {
+// Draws one published snapshot, never the live world (the next ticks may be
+// running on simThread).
+static void drawFrame(const RenderSnapshot &snap, float a, Profiler &timing) {
+    Text::prepare();   // first frame only: renders the glyphs, before the clear
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    // player + camera as they are between the last two ticks
+    Player view = snap.player;
+    view.setColorIndex(gPlayerColorIndex);
+    view.x = snap.player.prevX + (snap.player.x - snap.player.prevX) * a;
+    view.y = snap.player.prevY + (snap.player.y - snap.player.prevY) * a;
+    float viewZoom = snap.prevZoom + (snap.zoom - snap.prevZoom) * a;
+
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
-    gluLookAt(player.x, player.y, zoom,
-              player.x, player.y, 0,
+    gluLookAt(view.x, view.y, viewZoom,
+              view.x, view.y, 0,
               0, 1, 0);
 
+    // what of the z = 0 plane ends up on screen with this camera and tilt
+    const ViewRect cull = ViewRect::fromCamera(view.x, view.y, viewZoom, g_aspect, snap.rotX, snap.rotY);
+    // player bullets are drawn after the tilt is popped, so they cull untilted
+    const ViewRect flatCull = ViewRect::fromCamera(view.x, view.y, viewZoom, g_aspect, 0.0f, 0.0f);
+
+    // circles in the world get as many segments as their size on screen needs
+    Shapes::pixelsPerUnit() = Shapes::pixelsPerUnitAt(viewZoom, gH);
+
     glPushMatrix();
-    glTranslatef(player.x, player.y, 0.0f);
-    glRotatef(movement.rotX, 1, 0, 0);
-    glRotatef(movement.rotY, 0, 1, 0);
-    glTranslatef(-player.x, -player.y, 0.0f);
+    glTranslatef(view.x, view.y, 0.0f);
+    glRotatef(snap.rotX, 1, 0, 0);
+    glRotatef(snap.rotY, 0, 1, 0);
+    glTranslatef(-view.x, -view.y, 0.0f);
+
+    {
+        Profiler::Scope s(timing, Profiler::DRAW_BG);
+        Background::DrawStats st = snap.bg.draw(view, batch, cull);
+        timing.count(Profiler::CULL_PLANETS, st.planets, st.planets + st.planetsCulled);
+    }
 
-    bg.draw(player);
+    if (snap.playing) {
+        {
+            Profiler::Scope s(timing, Profiler::DRAW_ENEMIES);
+            int n = EnemySystem::draw(snap.enemies, batch, a, cull);
+            timing.count(Profiler::CULL_ENEMIES, n, (int)snap.enemies.size());
 
-    if (gameState == 1) {
-        enemies.draw();
-        glDisable(GL_DEPTH_TEST);
-        enemyCombat.draw();
-        fx.draw();
+            glDisable(GL_DEPTH_TEST);
+            n = snap.enemyCombat.draw(batch, a, cull);
+            timing.count(Profiler::CULL_ENEMY_BULLETS, n, snap.enemyCombat.bullets.size());
+        }
+        {
+            Profiler::Scope s(timing, Profiler::DRAW_FX);
+            int n = snap.fx.draw(batch, cull);
+            timing.count(Profiler::CULL_BOOMS, n, snap.fx.booms.size());
+        }
         glEnable(GL_DEPTH_TEST);
     }
 
     glPopMatrix();
 
-    glDisable(GL_DEPTH_TEST);
-    shooting.drawAimPreview(player);
-    shooting.drawBullets();
-    glEnable(GL_DEPTH_TEST);
+    {
+        Profiler::Scope s(timing, Profiler::DRAW_PLAYER);
 
-    // apply chosen skin color before drawing player
-    player.setColorIndex(gPlayerColorIndex);
+        glDisable(GL_DEPTH_TEST);
+        snap.shooting.drawAimPreview(view);
+        int n = snap.shooting.drawBullets(batch, a, flatCull);
+        timing.count(Profiler::CULL_BULLETS, n, snap.shooting.bullets.size());
+        glEnable(GL_DEPTH_TEST);
 
-    glDisable(GL_DEPTH_TEST);
-    player.draw();
-    glEnable(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+        view.draw();
+        glEnable(GL_DEPTH_TEST);
+    }
+
+    // HUD and menus are laid out in pixels already, keep them at full detail
+    Shapes::pixelsPerUnit() = 0.0f;
 
-    if (gameState == 1) hud.draw(gW, gH, player.hp);
+    if (snap.playing) {
+        Profiler::Scope s(timing, Profiler::DRAW_HUD);
+        snap.hud.draw(gW, gH, snap.player.hp);
+    }
+    prof.drawOverlay(gW, gH);
 
     if (gameState == 0) {
         float mxUI, myUI;
@@ -189,15 +262,31 @@ static void display() {
 
     if (gameState == 1 && gPaused) drawPauseOverlay();
 
+    // the frame's temporaries (and the audio commands since the last one) are done
+    Arena &scratch = Arena::frame();
+    scratch.reset();
+    timing.count(Profiler::FRAME_ARENA, scratch.lastPeakKB(), scratch.capacityKB());
+
     glutSwapBuffers();
 }
 
+// expose / resize / mouse motion: simThread is idle whenever GLUT calls back.
+// These only re-present the last frame, so they are not timed: a profiler
+// frame is one pass of the idle loop.
+static void display() {
+    static Profiler untimed;   // never enabled
+    drawFrame(snapshots.latest(), gRenderAlpha, untimed);
+}
+
 void reshape(int w, int h) {
     if (h == 0) h = 1;
 
     gW = w;
     gH = h;
-    g_aspect = (float)w / (float)h;
+    g_aspect = InputLog::aspectOf(w, h);
+
+    // enemies spawn just outside the view, so a replay needs the window shape
+    recorder.write(world.tick, InputEvent::make(InputEvent::RESIZE, w, h));
 
     glViewport(0, 0, w, h);
 
@@ -212,9 +301,25 @@ void reshape(int w, int h) {
 }
 
 // ---------------------------------
-void update(int) {
+// Idle loop: run however many fixed ticks the elapsed wall time is worth, then
+// draw once. A hitch costs frames, not game speed, and a 144 Hz display gets
+// 144 interpolated frames out of 60 ticks.
+// The ticks run on simThread while this thread draws the previous frame, and
+// are waited for before returning, so GLUT callbacks only see an idle world.
+void update() {
+    using clock = std::chrono::steady_clock;
+    static clock::time_point last = clock::now();
     static bool prevPaused = false;
 
+    clock::time_point now = clock::now();
+    double dt = std::chrono::duration<double>(now - last).count();
+    if (gMaxFps > 0 && dt < 1.0 / gMaxFps) {
+        // sleep off the rest of the frame instead of spinning the idle loop
+        std::this_thread::sleep_for(std::chrono::duration<double>(1.0 / gMaxFps - dt));
+        return;
+    }
+    last = now;
+
     // pause transitions
     if (!prevPaused && gPaused) {
         Audio::pauseBgm();
@@ -225,75 +330,73 @@ void update(int) {
     }
     prevPaused = gPaused;
 
-    // freeze gameplay while paused
+    // freeze gameplay while paused (wall time is dropped, not banked)
     if (gameState == 1 && gPaused) {
-        glutPostRedisplay();
-        glutTimerFunc(16, update, 0);
+        drawFrame(snapshots.latest(), gRenderAlpha, prof);
+        prof.endFrame();
         return;
     }
 
-    // smooth zoom
-    if (targetZoom < 1.2f) targetZoom = 1.2f;
-    if (targetZoom > 6.0f) targetZoom = 6.0f;
-    zoom += (targetZoom - zoom) * 0.18f;
-
-    // allow movement + aim + shooting update even in HOME
-    movement.update(player, targetZoom);
-    playerMove.update(player, movement);
+    // The snapshot on screen is the previous frame's, so is its alpha. Take it
+    // before kick(): simThread may publish a new one before drawFrame runs, and
+    // the triple buffer never writes the slot the reader holds.
+    const RenderSnapshot &snap = snapshots.latest();
+    float drawAlpha = gRenderAlpha;
 
+    int ticks = simClock.advance(dt);
     Input::updateAimFromMouse();
-    shooting.update(player);
-
-    bg.update(player, movement);
-
-    if (gameState == 1) {
-        hud.update();
-        enemies.setDifficulty(hud.level);
-
-        enemies.update(player, zoom, g_aspect);
-        enemyCombat.update(enemies, player);
-
-        player.updateDamageTimers();
-        collision.bulletEnemy(shooting, enemies, fx, hud);
-
-        fx.update();
-
-        // ---- slowdown protection (caps) ----
-        if (enemyCombat.bullets.size() > 800) {
-            enemyCombat.bullets.erase(enemyCombat.bullets.begin(),
-                                      enemyCombat.bullets.begin() + (enemyCombat.bullets.size() - 800));
-        }
-        if (fx.booms.size() > 300) {
-            fx.booms.erase(fx.booms.begin(),
-                           fx.booms.begin() + (fx.booms.size() - 300));
+    world.prof.enabled = prof.enabled;
+    simThread.kick(ticks, gameState == 1);
+
+    drawFrame(snap, drawAlpha, prof);
+
+    simThread.wait();
+    gRenderAlpha = simClock.alpha();
+
+    // this batch's stage times and tick count land in the same row as its draw
+    prof.merge(world.prof);
+    prof.addTicks(ticks);
+
+    if (ticks > 0) {
+        Profiler::Scope s(prof, Profiler::AUDIO);
+
+        if (gameState == 1) {
+            // sound triggers
+            bool movingNow = (std::fabs(movement.dx) > 0.00001f) || (std::fabs(movement.dy) > 0.00001f);
+            Audio::setMoveLoop(movingNow);
+
+            bool shootingNow = (shooting.fireMouse || shooting.fireKeyR);
+            Audio::setShootLoop(shootingNow);
+
+            if (hud.score > gPrevScore) {
+                Audio::enemyHit(hud.score - gPrevScore);
+                gPrevScore = hud.score;
+            }
+
+            if (player.hp < gPrevHP) {
+                Audio::playerHit();
+                gPrevHP = player.hp;
+            }
+        } else {
+            // HOME
+            Audio::setMoveLoop(false);
+            Audio::setShootLoop(false);
         }
+    }
 
-        // sound triggers
-        bool movingNow = (std::fabs(movement.dx) > 0.00001f) || (std::fabs(movement.dy) > 0.00001f);
-        Audio::setMoveLoop(movingNow);
-
-        bool shootingNow = (shooting.fireMouse || shooting.fireKeyR);
-        Audio::setShootLoop(shootingNow);
+    AudioMixer::Stats mix = Audio::takeStats();
+    prof.add(Profiler::AUDIO_MIX, mix.mixMs);
+    prof.count(Profiler::AUDIO_VOICES, mix.peakVoices, AudioMixer::MAX_VOICES);
 
-        if (hud.score > gPrevScore) {
-            Audio::enemyHit();
-            gPrevScore = hud.score;
-        }
+    prof.endFrame();
+}
 
-        if (player.hp < gPrevHP) {
-            Audio::playerHit();
-            gPrevHP = player.hp;
-        }
-    } else {
-        // HOME
-        player.updateDamageTimers();
-        fx.update();
-        Audio::setMoveLoop(false);
-        Audio::setShootLoop(false);
-    }
+static void finishRecording() {
+    recorder.finish(world);
+}
 
-    glutPostRedisplay();
-    glutTimerFunc(16, update, 0);
+static void finishProfile() {
+    prof.closeCsv();
 }
 
 int main(int argc, char *argv[]) {
@@ -306,18 +409,47 @@ int main(int argc, char *argv[]) {
 
     glClearColor(0.02f, 0.02f, 0.05f, 1.0f);
     glEnable(GL_DEPTH_TEST);
+    enableVsync();
+
+    Simulation::init(world);
+    menuUI.layout(gW, gH);
+
+    // a few workers for the big hordes, --threads 1 keeps the tick on this thread
+    int threads = std::min(4, std::max(1, (int)std::thread::hardware_concurrency()));
+
+    // glutInit has already taken its own arguments out of argv
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!std::strcmp(argv[i], "--record")) {
+            if (recorder.openWrite(argv[i + 1], world.seed)) {
+                Input::setRecorder(&recorder, &world.tick);
+                std::atexit(finishRecording);
+            }
+        }
+        if (!std::strcmp(argv[i], "--profile-csv")) {
+            if (prof.openCsv(argv[i + 1])) std::atexit(finishProfile);
+        }
+        if (!std::strcmp(argv[i], "--threads")) threads = std::atoi(argv[i + 1]);
+        if (!std::strcmp(argv[i], "--max-fps")) gMaxFps = std::max(0, std::atoi(argv[i + 1]));
+        // speeds and cooldowns are per tick, so this is also the game speed
+        if (!std::strcmp(argv[i], "--tick-hz")) {
+            double hz = std::atof(argv[i + 1]);
+            if (hz > 0.0) simClock.tickHz = hz;
+        }
+        if (!std::strcmp(argv[i], "--stars")) {
+            bg.starCount = std::max(0, std::atoi(argv[i + 1]));
+            bg.init(world.seed);
+        }
+        if (!std::strcmp(argv[i], "--audio-wav")) Audio::WAV_OUT = argv[i + 1];
+    }
+    world.jobs.start(threads);
 
     Audio::init("Audio");
     Audio::playHomeBgm();
 
-    bg.init();
-    enemies.init();
-    hud.reset();
-    menuUI.layout(gW, gH);
-
-    player.x = 0.0f;
-    player.y = 0.0f;
-    player.scale = 1.0f;
+    // something to draw before the first batch of ticks lands
+    snapshots.back().capture(world, false);
+    snapshots.publish();
+    simThread.start(&world, &snapshots);
 
     Input::init(&player, &movement, &shooting,
                 &gW, &gH, &g_aspect,
@@ -327,7 +459,7 @@ int main(int argc, char *argv[]) {
 
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
-    glutTimerFunc(0, update, 0);
+    glutIdleFunc(update);
 
     glutMainLoop();
     return 0;